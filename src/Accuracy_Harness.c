@@ -0,0 +1,282 @@
+/** @file
+ *  @brief accuracy harness file.
+ *  @description This module compares the torque and ADC implementations against
+ *  		 a double precision reference model, so that faster engines can be
+ *  		 accepted or rejected on their max/RMS error and throughput.
+ */
+
+#include "Accuracy_Harness.h"
+
+#include "Torque_Module.h"
+#include "Torque_Cache.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+/** Exact conversion, MAX_ADC_VOLTAGE is given in milli-volts */
+#define ADC_COUNTS_PER_VOLT		((double)ADC_RESOLUTION*1000/MAX_ADC_VOLTAGE)
+
+static volatile double s_harness_sink	=	0.0;
+
+typedef struct {
+	double max_error;
+	double sum_sq_error;
+	unsigned long samples;
+}HarnessError_t;
+
+double ref_torque(double angle, unsigned int speed)
+/**
+ * Description: Double precision reference of the pedal map.
+ * Inputs: 	angle
+ * 	: 	speed
+ * Output:
+ * return: 	torque
+ */
+{
+	double lv_torque_0_deg = TORQUE_AT_REST_0_DEG + \
+			(double)(TORQUE_AT_50KM_0_DEG - TORQUE_AT_REST_0_DEG) * speed / MAX_POSSIBLE_SPEED;
+
+	return lv_torque_0_deg + (TORQUE_AT_MAX_ANGLE - lv_torque_0_deg) * angle / MAX_ANGLE;
+}
+
+double ref_adc_voltage(adc_channel_id_t inID, double angle)
+/**
+ * Description: Double precision reference of the adc1/adc2 formulas.
+ * Inputs: 	adc_channel_id_t (inID)
+ * 	: 	angle
+ * Output:
+ * return: 	voltage
+ */
+{
+	return inID == ADC_CHANNEL0 ? ADC1_MIN_VOLT + 0.1 * angle : ADC2_MIN_VOLT + 0.08 * angle;
+}
+
+/************************************************
+ *  Engines under test
+ ***********************************************/
+static double eval_torque_rpm_based(float angle, unsigned int speed)
+{
+	return get_torque_rpm_based_speed(angle, speed);
+}
+
+static double eval_torque_two_speed(float angle, unsigned int speed)
+{
+	return get_torque_two_speed(angle, speed == SPEED_AT_REST ? Resting : Moving);
+}
+
+static double eval_torque_cached_rpm(float angle, unsigned int speed)
+{
+	return get_torque_cached(angle, speed, false);
+}
+
+static double eval_torque_cached_two_speed(float angle, unsigned int speed)
+{
+	return get_torque_cached(angle, speed, true);
+}
+
+static double ref_torque_rpm_based(double angle, unsigned int speed)
+{
+	return get_torque_rpm_based_speed((float)angle, speed);
+}
+
+static double ref_torque_two_speed(double angle, unsigned int speed)
+{
+	return get_torque_two_speed((float)angle, speed == SPEED_AT_REST ? Resting : Moving);
+}
+
+static double eval_adc1(float angle, unsigned int speed)
+{
+	(void)speed;
+	return calc_raw_adc_value(ADC_CHANNEL0, angle) / ADC_COUNTS_PER_VOLT;
+}
+
+static double eval_adc2(float angle, unsigned int speed)
+{
+	(void)speed;
+	return calc_raw_adc_value(ADC_CHANNEL1, angle) / ADC_COUNTS_PER_VOLT;
+}
+
+static double ref_adc1(double angle, unsigned int speed)
+{
+	(void)speed;
+	return ref_adc_voltage(ADC_CHANNEL0, angle);
+}
+
+static double ref_adc2(double angle, unsigned int speed)
+{
+	(void)speed;
+	return ref_adc_voltage(ADC_CHANNEL1, angle);
+}
+
+static const HarnessEngine_t s_harness_engines[] = {
+	{"torque_rpm_based",	eval_torque_rpm_based,		ref_torque,	HARNESS_TORQUE_TOLERANCE,	false},
+	{"torque_cached_rpm",	eval_torque_cached_rpm,		ref_torque,	HARNESS_TORQUE_TOLERANCE,	false},
+	{"torque_two_speed",	eval_torque_two_speed,		ref_torque,	HARNESS_TORQUE_TOLERANCE,	true},
+	{"torque_cached_ts",	eval_torque_cached_two_speed,	ref_torque,	HARNESS_TORQUE_TOLERANCE,	true},
+	{"cached_rpm_exact",	eval_torque_cached_rpm,		ref_torque_rpm_based,	HARNESS_EXACT_TOLERANCE,	false},
+	{"cached_ts_exact",	eval_torque_cached_two_speed,	ref_torque_two_speed,	HARNESS_EXACT_TOLERANCE,	true},
+	{"adc1_raw",		eval_adc1,			ref_adc1,	HARNESS_ADC_TOLERANCE,		false},
+	{"adc2_raw",		eval_adc2,			ref_adc2,	HARNESS_ADC_TOLERANCE,		false},
+};
+
+/************************************************
+ *  Harness internals
+ ***********************************************/
+static uint32_t get_next_random(uint32_t *ioState)
+/**
+ * Description: xorshift32, so that random samples are reproducible and do not
+ * 		disturb the rand() state of the simulation.
+ * Inputs: 	ioState
+ * Output: 	ioState
+ * return: 	next pseudo random value
+ */
+{
+	uint32_t lv_x = *ioState;
+	lv_x ^= lv_x << 13;
+	lv_x ^= lv_x >> 17;
+	lv_x ^= lv_x << 5;
+	*ioState = lv_x;
+	return lv_x;
+}
+
+static double get_sqrt(double value)
+/**
+ * Description: Newton iteration square root, so the harness does not need libm.
+ * Inputs: 	value
+ * Output:
+ * return: 	square root of value
+ */
+{
+	double lv_Root = value > 1.0 ? value : 1.0;
+
+	if(value <= 0.0) {
+		return 0.0;
+	}
+	for(unsigned int i = 0; i < 64; i++) {
+		lv_Root = 0.5 * (lv_Root + value / lv_Root);
+	}
+	return lv_Root;
+}
+
+static double get_elapsed_seconds(const struct timespec *inStart)
+{
+	struct timespec lv_now;
+	clock_gettime(CLOCK_MONOTONIC, &lv_now);
+	return (lv_now.tv_sec - inStart->tv_sec) + (lv_now.tv_nsec - inStart->tv_nsec) / 1e9;
+}
+
+static unsigned int get_speed_count(const HarnessEngine_t *inEngine)
+{
+	return inEngine->two_speed_only ? SIMULATION_SPEED_LEVELS : MAX_POSSIBLE_SPEED + 1;
+}
+
+static unsigned int get_speed_at(const HarnessEngine_t *inEngine, unsigned int index)
+{
+	return inEngine->two_speed_only ? (index == Resting ? SPEED_AT_REST : SPEED_AT_MOVE) : index;
+}
+
+static void add_sample(HarnessError_t *ioError, const HarnessEngine_t *inEngine, float angle, unsigned int speed)
+{
+	double lv_Error = inEngine->evaluate(angle, speed) - inEngine->reference(angle, speed);
+
+	if(lv_Error < 0) {
+		lv_Error = -lv_Error;
+	}
+
+	if(lv_Error > ioError->max_error) {
+		ioError->max_error = lv_Error;
+	}
+	ioError->sum_sq_error += lv_Error * lv_Error;
+	ioError->samples++;
+}
+
+static double get_grid_angle(unsigned int step)
+{
+	return MIN_ANGLE + (double)(MAX_ANGLE - MIN_ANGLE) * step / HARNESS_ANGLE_GRID_STEPS;
+}
+
+static double measure_throughput(const HarnessEngine_t *inEngine, bool reference)
+/**
+ * Description: Measures evaluations per second over the full grid, either of the
+ * 		engine or of its reference.
+ * Inputs: 	inEngine
+ * 	: 	reference
+ * Output:
+ * return: 	evaluations per second
+ */
+{
+	struct timespec lv_Start;
+	unsigned long lv_Count = 0;
+	double lv_Sum = 0.0;
+
+	clock_gettime(CLOCK_MONOTONIC, &lv_Start);
+	for(unsigned int s = 0; s < get_speed_count(inEngine); s++) {
+		unsigned int lv_Speed = get_speed_at(inEngine, s);
+		for(unsigned int a = 0; a <= HARNESS_ANGLE_GRID_STEPS; a++) {
+			lv_Sum += reference ? inEngine->reference(get_grid_angle(a), lv_Speed) : \
+					inEngine->evaluate((float)get_grid_angle(a), lv_Speed);
+			lv_Count++;
+		}
+	}
+	s_harness_sink = lv_Sum;
+
+	double lv_Elapsed = get_elapsed_seconds(&lv_Start);
+	return lv_Elapsed > 0 ? lv_Count / lv_Elapsed : 0.0;
+}
+
+int harness_evaluate_engine(const HarnessEngine_t *inEngine)
+/**
+ * Description: Evaluates an engine against its reference on the full grid and on
+ * 		random samples, and prints max/RMS error and throughput.
+ * Inputs: 	inEngine
+ * Output:
+ * return: 	OK / NOK
+ */
+{
+	HarnessError_t lv_Error = {0};
+	uint32_t lv_Random = HARNESS_RANDOM_SEED;
+
+	for(unsigned int s = 0; s < get_speed_count(inEngine); s++) {
+		for(unsigned int a = 0; a <= HARNESS_ANGLE_GRID_STEPS; a++) {
+			add_sample(&lv_Error, inEngine, (float)get_grid_angle(a), get_speed_at(inEngine, s));
+		}
+	}
+
+	for(unsigned int i = 0; i < HARNESS_RANDOM_SAMPLES; i++) {
+		float lv_Angle = MIN_ANGLE + (float)(MAX_ANGLE - MIN_ANGLE) * (get_next_random(&lv_Random) / (float)UINT32_MAX);
+		unsigned int lv_Speed = get_speed_at(inEngine, get_next_random(&lv_Random) % get_speed_count(inEngine));
+		add_sample(&lv_Error, inEngine, lv_Angle, lv_Speed);
+	}
+
+	double lv_Rms = get_sqrt(lv_Error.sum_sq_error / lv_Error.samples);
+	bool lv_Pass = lv_Error.max_error <= inEngine->tolerance;
+
+	printf("%-20s %8lu %10.4f %10.4f %12.2f %12.2f  %s\n", inEngine->name, lv_Error.samples,
+		   lv_Error.max_error, lv_Rms, measure_throughput(inEngine, false) / 1e6,
+		   measure_throughput(inEngine, true) / 1e6, lv_Pass ? "PASS" : "FAIL");
+
+	return lv_Pass ? OK : NOK;
+}
+
+int run_accuracy_harness(void)
+/**
+ * Description: Runs the harness for all registered torque and ADC engines.
+ * Inputs:
+ * Output:
+ * return: 	OK / NOK
+ */
+{
+	int lvResult = OK;
+
+	torque_cache_reset();
+
+	printf("%-20s %8s %10s %10s %12s %12s  %s\n", "engine", "samples", "max_err", "rms_err",
+		   "Meval/s", "ref_Meval/s", "result");
+
+	for(unsigned int i = 0; i < sizeof(s_harness_engines)/sizeof(s_harness_engines[0]); i++) {
+		if(harness_evaluate_engine(&s_harness_engines[i]) != OK) {
+			lvResult = NOK;
+		}
+	}
+	return lvResult;
+}
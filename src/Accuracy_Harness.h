@@ -0,0 +1,71 @@
+/**
+ * @file
+ * @brief Header file for the differential accuracy harness.
+ */
+
+#ifndef ACCURACY_HARNESS_H_
+#define ACCURACY_HARNESS_H_
+
+#include <stdbool.h>
+#include "drivers/adc_driver/adc_driver.h"
+
+/************************************************
+ *  Macro definitions used by the harness.
+ ***********************************************/
+#define HARNESS_ANGLE_GRID_STEPS	3000	// 0.01 degree resolution over [MIN_ANGLE, MAX_ANGLE]
+#define HARNESS_RANDOM_SAMPLES	100000
+#define HARNESS_RANDOM_SEED		0x2545F491u
+
+#define HARNESS_TORQUE_TOLERANCE	3.0	// Newton Meter, 1% throttle step plus truncation
+#define HARNESS_ADC_TOLERANCE		0.05	// Volts
+#define HARNESS_EXACT_TOLERANCE	0.0	// Cached engines against the uncached functions
+
+/************************************************
+ *  Structure definitions
+ ***********************************************/
+typedef struct {
+	const char *name;
+	double (*evaluate)(float angle, unsigned int speed);	// Implementation under test
+	double (*reference)(double angle, unsigned int speed);	// Double precision model
+	double tolerance;						// Max accepted absolute error
+	bool two_speed_only;						// Only SPEED_AT_REST and SPEED_AT_MOVE are valid
+}HarnessEngine_t;
+
+/************************************************
+ *  Function definitions
+ ***********************************************/
+
+/** @brief Double precision reference of the pedal map.
+ *  @param[in]  angle in degrees.
+ *  @param[in]  speed in km/h.
+ *  @param[ret] torque in Newton Meter.
+ *  @note Torque rises linearly from its 0 degree value, which falls linearly with speed
+ * 	   from TORQUE_AT_REST_0_DEG to TORQUE_AT_50KM_0_DEG, up to TORQUE_AT_MAX_ANGLE.
+ */
+double ref_torque(double angle, unsigned int speed);
+
+/** @brief Double precision reference of the adc1/adc2 formulas.
+ *  @param[in]  adc_channel_id_t.
+ *  @param[in]  angle in degrees.
+ *  @param[ret] voltage
+ *  @note
+ */
+double ref_adc_voltage(adc_channel_id_t inID, double angle);
+
+/** @brief Evaluates an engine against its reference on the full (angle, speed) grid
+ * 	   and on random samples, and prints max/RMS error and throughput.
+ *  @param[in]  inEngine engine to evaluate.
+ *  @param[ret] OK if the max error is within the tolerance of the engine, NOK otherwise.
+ *  @note
+ */
+int harness_evaluate_engine(const HarnessEngine_t *inEngine);
+
+/** @brief Runs the harness for all registered torque and ADC engines.
+ *  @param[in]
+ *  @param[ret] OK if all engines are within their tolerance, NOK otherwise.
+ *  @note Resets the torque cache. The torque tables are used as initialized at startup,
+ * 	   so the table state of the production modes is what gets verified.
+ */
+int run_accuracy_harness(void);
+
+#endif /* ACCURACY_HARNESS_H_ */
@@ -0,0 +1,241 @@
+/** @file
+ *  @brief fault recorder file.
+ *  @description This module keeps a persistent log of timestamped fault events with
+ *  		 freeze frame data in a memory-mapped ring file, and drives the error
+ *  		 LED on fault state changes only.
+ */
+
+#include "Fault_Recorder.h"
+
+#include "Torque_Module.h"
+#include "drivers/error_led/error_led.h"
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+static FaultLog_t s_fallback_log			=	{0};
+static FaultLog_t *s_fault_log				=	&s_fallback_log;
+static bool s_fault_log_mapped				=	false;
+
+static bool s_fault_active[_FaultCodes]		=	{false};
+static uint32_t s_fault_active_sequence[_FaultCodes]	=	{0};
+static unsigned int s_fault_active_count		=	0;
+
+static pthread_mutex_t s_FaultMutex			=	PTHREAD_MUTEX_INITIALIZER;
+
+static const char *s_fault_names[_FaultCodes]	=	{"THROTTLE_RANGE", "SPEED_RANGE",
+								   "ANGLE_STALL", "SPEED_STALL", "TORQUE_STALL"};
+
+static uint64_t get_realtime_ns(void)
+{
+	struct timespec lv_now;
+	clock_gettime(CLOCK_REALTIME, &lv_now);
+	return (uint64_t)lv_now.tv_sec * 1000000000ull + lv_now.tv_nsec;
+}
+
+static void format_fault_log(FaultLog_t *ioLog)
+{
+	memset(ioLog, 0, sizeof(*ioLog));
+	ioLog->magic		=	FAULT_RECORDER_MAGIC;
+	ioLog->version		=	FAULT_RECORDER_VERSION;
+	ioLog->record_size	=	sizeof(FaultRecord_t);
+	ioLog->capacity	=	FAULT_RECORDER_CAPACITY;
+}
+
+static bool is_fault_log_valid(const FaultLog_t *inLog)
+{
+	return inLog->magic == FAULT_RECORDER_MAGIC && inLog->version == FAULT_RECORDER_VERSION && \
+		   inLog->record_size == sizeof(FaultRecord_t) && inLog->capacity == FAULT_RECORDER_CAPACITY;
+}
+
+int fault_recorder_init(const char *path)
+/**
+ * Description: Maps the fault log file, creating or re-initializing it when it is
+ * 		missing or incompatible. Falls back to an in-memory log on failure.
+ * Inputs: 	path
+ * Output:
+ * return: 	OK / NOK
+ */
+{
+	int lv_fd = open(path, O_RDWR | O_CREAT, 0644);
+	struct stat lv_stat;
+	bool lv_existing = lv_fd >= 0 && fstat(lv_fd, &lv_stat) == 0 && lv_stat.st_size != 0;
+
+	/** A log of another size cannot be valid, report it before it is resized */
+	if(lv_existing && lv_stat.st_size != sizeof(FaultLog_t)) {
+		printf("[FAULT] %s is not a compatible fault log, re-initializing it\n", path);
+		lv_existing = false;
+	}
+
+	if(lv_fd < 0 || ftruncate(lv_fd, sizeof(FaultLog_t)) != 0) {
+		printf("[FAULT] Could not open %s, recording in memory only\n", path);
+		if(lv_fd >= 0) {
+			close(lv_fd);
+		}
+		format_fault_log(&s_fallback_log);
+		return NOK;
+	}
+
+	void *lv_map = mmap(NULL, sizeof(FaultLog_t), PROT_READ | PROT_WRITE, MAP_SHARED, lv_fd, 0);
+	close(lv_fd);
+
+	if(lv_map == MAP_FAILED) {
+		printf("[FAULT] Could not map %s, recording in memory only\n", path);
+		format_fault_log(&s_fallback_log);
+		return NOK;
+	}
+
+	s_fault_log = (FaultLog_t*)lv_map;
+	s_fault_log_mapped = true;
+
+	if(!is_fault_log_valid(s_fault_log)) {
+		if(lv_existing) {
+			printf("[FAULT] %s is not a compatible fault log, re-initializing it\n", path);
+		}
+		format_fault_log(s_fault_log);
+	}
+	printf("[FAULT] Fault log %s with %u records\n", path, s_fault_log->next_sequence);
+	return OK;
+}
+
+void fault_recorder_raise(FaultCode code, const FaultFreezeFrame_t *frame)
+/**
+ * Description: Records a fault, de-duplicating repeated occurrences of an active fault
+ * 		into its existing record. The LED is only driven when the first fault
+ * 		becomes active.
+ * Inputs: 	code
+ * 	: 	frame
+ * Output:
+ * return:
+ */
+{
+	uint64_t lv_now = get_realtime_ns();
+	bool lv_LedOn = false;
+
+	if(code >= _FaultCodes) {
+		return;
+	}
+
+	pthread_mutex_lock(&s_FaultMutex);
+
+	FaultRecord_t *lv_Record = &s_fault_log->records[s_fault_active_sequence[code] % FAULT_RECORDER_CAPACITY];
+
+	/** The active record may have been overwritten once the ring wrapped around */
+	if(s_fault_active[code] && lv_Record->sequence == s_fault_active_sequence[code] && lv_Record->code == code) {
+		lv_Record->last_seen_ns = lv_now;
+		if(lv_Record->occurrences < UINT16_MAX) {
+			lv_Record->occurrences++;
+		}
+	} else {
+		uint32_t lv_Sequence = s_fault_log->next_sequence++;
+
+		lv_Record = &s_fault_log->records[lv_Sequence % FAULT_RECORDER_CAPACITY];
+		lv_Record->first_seen_ns	=	lv_now;
+		lv_Record->last_seen_ns	=	lv_now;
+		lv_Record->sequence		=	lv_Sequence;
+		lv_Record->occurrences	=	1;
+		lv_Record->code		=	code;
+		lv_Record->freeze_frame	=	*frame;
+
+		s_fault_active_sequence[code] = lv_Sequence;
+		if(!s_fault_active[code]) {
+			s_fault_active[code] = true;
+			lv_LedOn = (s_fault_active_count++ == 0);
+		}
+	}
+
+	/** Driven under the lock, so the last LED write always matches the active count */
+	if(lv_LedOn) {
+		error_led_set(true);
+	}
+	pthread_mutex_unlock(&s_FaultMutex);
+}
+
+void fault_recorder_clear(FaultCode code)
+/**
+ * Description: Marks a fault as no longer active, switching the LED off when no
+ * 		fault remains active.
+ * Inputs: 	code
+ * Output:
+ * return:
+ */
+{
+	bool lv_LedOff = false;
+
+	if(code >= _FaultCodes) {
+		return;
+	}
+
+	pthread_mutex_lock(&s_FaultMutex);
+	if(s_fault_active[code]) {
+		s_fault_active[code] = false;
+		lv_LedOff = (--s_fault_active_count == 0);
+	}
+	if(lv_LedOff) {
+		error_led_set(false);
+	}
+	pthread_mutex_unlock(&s_FaultMutex);
+}
+
+bool fault_recorder_any_active(void)
+/**
+ * Description: Returns whether any fault is currently active.
+ * Inputs:
+ * Output:
+ * return: 	true / false
+ */
+{
+	pthread_mutex_lock(&s_FaultMutex);
+	bool lv_Active = s_fault_active_count != 0;
+	pthread_mutex_unlock(&s_FaultMutex);
+	return lv_Active;
+}
+
+void fault_recorder_dump(void)
+/**
+ * Description: Prints all records of the fault log, oldest first.
+ * Inputs:
+ * Output:
+ * return:
+ */
+{
+	uint32_t lv_Last = s_fault_log->next_sequence;
+	uint32_t lv_First = lv_Last > FAULT_RECORDER_CAPACITY ? lv_Last - FAULT_RECORDER_CAPACITY : 0;
+
+	printf("[FAULT] %u records, showing %u\n", lv_Last, lv_Last - lv_First);
+	for(uint32_t seq = lv_First; seq < lv_Last; seq++) {
+		const FaultRecord_t *lv_Record = &s_fault_log->records[seq % FAULT_RECORDER_CAPACITY];
+
+		printf("#%u %s x%u first:%llu.%09llu last:%llu.%09llu | Angle:%.2fDeg Speed:%uKm/h ADC1:%u ADC2:%u\n",
+			   lv_Record->sequence, lv_Record->code < _FaultCodes ? s_fault_names[lv_Record->code] : "UNKNOWN",
+			   lv_Record->occurrences,
+			   (unsigned long long)(lv_Record->first_seen_ns / 1000000000ull), (unsigned long long)(lv_Record->first_seen_ns % 1000000000ull),
+			   (unsigned long long)(lv_Record->last_seen_ns / 1000000000ull), (unsigned long long)(lv_Record->last_seen_ns % 1000000000ull),
+			   lv_Record->freeze_frame.angle, lv_Record->freeze_frame.speed,
+			   lv_Record->freeze_frame.adc[ADC_CHANNEL0], lv_Record->freeze_frame.adc[ADC_CHANNEL1]);
+	}
+}
+
+void fault_recorder_close(void)
+/**
+ * Description: Flushes and unmaps the fault log.
+ * Inputs:
+ * Output:
+ * return:
+ */
+{
+	pthread_mutex_lock(&s_FaultMutex);
+	if(s_fault_log_mapped) {
+		(void)msync(s_fault_log, sizeof(FaultLog_t), MS_SYNC);
+		(void)munmap(s_fault_log, sizeof(FaultLog_t));
+		s_fault_log = &s_fallback_log;
+		s_fault_log_mapped = false;
+		format_fault_log(&s_fallback_log);
+	}
+	pthread_mutex_unlock(&s_FaultMutex);
+}
@@ -0,0 +1,113 @@
+/**
+ * @file
+ * @brief Header file for the persistent fault recorder.
+ */
+
+#ifndef FAULT_RECORDER_H_
+#define FAULT_RECORDER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "drivers/adc_driver/adc_driver.h"
+
+/************************************************
+ *  Macro definitions used by the fault recorder.
+ ***********************************************/
+#define FAULT_RECORDER_FILE		"fault_log.bin"
+#define FAULT_RECORDER_CAPACITY	256		// Number of records in the ring
+#define FAULT_RECORDER_MAGIC		0x46524543u	// "FREC"
+#define FAULT_RECORDER_VERSION	1
+
+/************************************************
+ *  Enumeration definitions
+ ***********************************************/
+typedef enum {
+	FaultThrottleRange,	// Applied throttle below THROTTLE_ERR_THRESHOLD
+	FaultSpeedRange,	// Speed above MAX_POSSIBLE_SPEED
+	FaultAngleStall,	// Angle thread missed its watchdog deadline
+	FaultSpeedStall,	// Speed thread missed its watchdog deadline
+	FaultTorqueStall,	// Torque thread missed its watchdog deadline
+	_FaultCodes
+}FaultCode;
+
+/************************************************
+ *  Structure definitions
+ ***********************************************/
+typedef struct {
+	float angle;
+	uint16_t speed;
+	adc_value_t adc[ADC_NUM_CHANNELS];
+}FaultFreezeFrame_t;
+
+typedef struct {
+	uint64_t first_seen_ns;	// CLOCK_REALTIME of the first occurrence
+	uint64_t last_seen_ns;		// CLOCK_REALTIME of the latest occurrence
+	uint32_t sequence;		// Monotonic record number
+	uint16_t occurrences;		// Saturates at UINT16_MAX
+	uint8_t code;			// FaultCode
+	uint8_t reserved;
+	FaultFreezeFrame_t freeze_frame;	// Captured at the first occurrence
+}FaultRecord_t;
+
+typedef struct {
+	uint32_t magic;
+	uint16_t version;
+	uint16_t record_size;
+	uint32_t capacity;
+	uint32_t next_sequence;	// Records written so far, next one goes to next_sequence % capacity
+	FaultRecord_t records[FAULT_RECORDER_CAPACITY];
+}FaultLog_t;
+
+/************************************************
+ *  Function definitions
+ ***********************************************/
+
+/** @brief Maps the fault log file, creating or re-initializing it when it is
+ * 	   missing or incompatible.
+ *  @param[in]  path of the fault log file.
+ *  @param[ret] OK if the log is persistent, NOK if it falls back to memory only.
+ *  @note Faults are recorded in either case. An existing incompatible log is reported
+ * 	   before it is re-initialized.
+ */
+int fault_recorder_init(const char *path);
+
+/** @brief Records a fault. A fault that is already active only bumps the occurrence
+ * 	   count and timestamp of its record. The error LED is switched on when the
+ * 	   first fault becomes active.
+ *  @param[in]  code of the fault.
+ *  @param[in]  freeze frame captured with the fault.
+ *  @param[ret]
+ *  @note Constant time, the log is flushed by the kernel or fault_recorder_close().
+ */
+void fault_recorder_raise(FaultCode code, const FaultFreezeFrame_t *frame);
+
+/** @brief Marks a fault as no longer active. The error LED is switched off when
+ * 	   no fault remains active.
+ *  @param[in]  code of the fault.
+ *  @param[ret]
+ *  @note
+ */
+void fault_recorder_clear(FaultCode code);
+
+/** @brief Returns whether any fault is currently active.
+ *  @param[in]
+ *  @param[ret] true if at least one fault is active.
+ *  @note
+ */
+bool fault_recorder_any_active(void);
+
+/** @brief Prints all records of the fault log, oldest first.
+ *  @param[in]
+ *  @param[ret]
+ *  @note
+ */
+void fault_recorder_dump(void);
+
+/** @brief Flushes and unmaps the fault log.
+ *  @param[in]
+ *  @param[ret]
+ *  @note
+ */
+void fault_recorder_close(void);
+
+#endif /* FAULT_RECORDER_H_ */
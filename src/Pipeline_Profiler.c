@@ -0,0 +1,151 @@
+/** @file
+ *  @brief pipeline profiler file.
+ *  @description This module measures how fast the complete angle, speed and torque
+ *  		 pipeline runs, so execution strategies can be compared on the real
+ *  		 code path.
+ */
+
+#include "Pipeline_Profiler.h"
+
+#include <stdatomic.h>
+#include <time.h>
+
+static const char *s_stage_names[_PipelineStages]		=	{"angle", "speed", "torque"};
+
+static atomic_uint_fast64_t s_stage_ns[_PipelineStages]	=	{0};
+static atomic_uint_fast64_t s_stage_calls[_PipelineStages]	=	{0};
+
+static uint32_t s_latency_histogram[PROFILER_LATENCY_BINS]	=	{0};
+static uint64_t s_latency_max_ns				=	0;
+static uint64_t s_cycles					=	0;
+static uint64_t s_failed_cycles				=	0;
+static uint64_t s_start_ns					=	0;
+static uint64_t s_end_ns					=	0;
+
+uint64_t profiler_now_ns(void)
+/**
+ * Description: Returns CLOCK_MONOTONIC in nanoseconds.
+ * Inputs:
+ * Output:
+ * return: 	nanoseconds
+ */
+{
+	struct timespec lv_now;
+	clock_gettime(CLOCK_MONOTONIC, &lv_now);
+	return (uint64_t)lv_now.tv_sec * 1000000000ull + lv_now.tv_nsec;
+}
+
+void profiler_start(void)
+/**
+ * Description: Clears all counters and starts the wall clock of the run.
+ * Inputs:
+ * Output:
+ * return:
+ */
+{
+	for(unsigned int i = 0; i < _PipelineStages; i++) {
+		atomic_store(&s_stage_ns[i], 0);
+		atomic_store(&s_stage_calls[i], 0);
+	}
+	for(unsigned int b = 0; b < PROFILER_LATENCY_BINS; b++) {
+		s_latency_histogram[b] = 0;
+	}
+	s_latency_max_ns = s_cycles = s_failed_cycles = 0;
+	s_start_ns = s_end_ns = profiler_now_ns();
+}
+
+void profiler_add_stage(PipelineStage stage, uint64_t ns)
+/**
+ * Description: Adds the time spent in a stage.
+ * Inputs: 	stage
+ * 	: 	ns
+ * Output:
+ * return:
+ */
+{
+	atomic_fetch_add_explicit(&s_stage_ns[stage], ns, memory_order_relaxed);
+	atomic_fetch_add_explicit(&s_stage_calls[stage], 1, memory_order_relaxed);
+}
+
+void profiler_add_cycle(uint64_t ns, bool failed)
+/**
+ * Description: Adds the latency of a complete cycle to the histogram.
+ * Inputs: 	ns
+ * 	: 	failed
+ * Output:
+ * return:
+ */
+{
+	uint64_t lv_Bin = ns / PROFILER_LATENCY_BIN_NS;
+
+	s_latency_histogram[lv_Bin < PROFILER_LATENCY_BINS ? lv_Bin : PROFILER_LATENCY_BINS - 1]++;
+	if(ns > s_latency_max_ns) {
+		s_latency_max_ns = ns;
+	}
+	s_cycles++;
+	s_end_ns = profiler_now_ns();
+	if(failed) {
+		s_failed_cycles++;
+	}
+}
+
+static uint64_t get_latency_quantile(double quantile)
+/**
+ * Description: Returns the upper edge of the histogram bin holding the quantile.
+ * Inputs: 	quantile
+ * Output:
+ * return: 	nanoseconds
+ */
+{
+	uint64_t lv_Rank = (uint64_t)(quantile * (s_cycles - 1) + 0.5) + 1;
+	uint64_t lv_Seen = 0;
+
+	for(unsigned int b = 0; b < PROFILER_LATENCY_BINS - 1; b++) {
+		lv_Seen += s_latency_histogram[b];
+		if(lv_Seen >= lv_Rank) {
+			return (uint64_t)(b + 1) * PROFILER_LATENCY_BIN_NS;
+		}
+	}
+	return s_latency_max_ns;
+}
+
+void profiler_report(FILE *out, bool failures)
+/**
+ * Description: Prints cycles/s, the time share of each stage and the cycle latency
+ * 		quantiles of the run.
+ * Inputs: 	out
+ * 	: 	failures
+ * Output:
+ * return:
+ */
+{
+	/** Up to the last cycle, so stopping and joining the threads is not included */
+	double lv_Elapsed_s = (s_end_ns - s_start_ns) / 1e9;
+	uint64_t lv_Total_Stage_ns = 0;
+
+	for(unsigned int i = 0; i < _PipelineStages; i++) {
+		lv_Total_Stage_ns += atomic_load(&s_stage_ns[i]);
+	}
+
+	fprintf(out, "Cycles: %llu", (unsigned long long)s_cycles);
+	if(failures) {
+		fprintf(out, " (%llu failed)", (unsigned long long)s_failed_cycles);
+	}
+	fprintf(out, " in %.3f s => %.0f cycles/s\n", lv_Elapsed_s, lv_Elapsed_s > 0 ? s_cycles / lv_Elapsed_s : 0.0);
+
+	for(unsigned int i = 0; i < _PipelineStages; i++) {
+		uint64_t lv_ns = atomic_load(&s_stage_ns[i]);
+		uint64_t lv_calls = atomic_load(&s_stage_calls[i]);
+
+		fprintf(out, "Stage %-7s calls:%-10llu avg:%9.1f ns share:%5.1f%%\n", s_stage_names[i],
+				(unsigned long long)lv_calls, lv_calls ? (double)lv_ns / lv_calls : 0.0,
+				lv_Total_Stage_ns ? 100.0 * lv_ns / lv_Total_Stage_ns : 0.0);
+	}
+
+	if(s_cycles) {
+		fprintf(out, "Cycle latency p50:%llu ns p90:%llu ns p99:%llu ns p99.9:%llu ns max:%llu ns\n",
+				(unsigned long long)get_latency_quantile(0.5), (unsigned long long)get_latency_quantile(0.9),
+				(unsigned long long)get_latency_quantile(0.99), (unsigned long long)get_latency_quantile(0.999),
+				(unsigned long long)s_latency_max_ns);
+	}
+}
@@ -0,0 +1,72 @@
+/**
+ * @file
+ * @brief Header file for the pipeline throughput profiler.
+ */
+
+#ifndef PIPELINE_PROFILER_H_
+#define PIPELINE_PROFILER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/************************************************
+ *  Macro definitions used by the profiler.
+ ***********************************************/
+#define PROFILER_LATENCY_BIN_NS	10	// Resolution of the cycle latency histogram
+#define PROFILER_LATENCY_BINS		10000	// Up to 100 us, slower cycles go to the last bin
+
+/************************************************
+ *  Enumeration definitions
+ ***********************************************/
+typedef enum {
+	StageAngle,
+	StageSpeed,
+	StageTorque,
+	_PipelineStages
+}PipelineStage;
+
+/************************************************
+ *  Function definitions
+ ***********************************************/
+
+/** @brief Returns CLOCK_MONOTONIC in nanoseconds.
+ *  @param[in]
+ *  @param[ret] nanoseconds
+ *  @note
+ */
+uint64_t profiler_now_ns(void);
+
+/** @brief Clears all counters and starts the wall clock of the run.
+ *  @param[in]
+ *  @param[ret]
+ *  @note
+ */
+void profiler_start(void);
+
+/** @brief Adds the time spent in a stage.
+ *  @param[in]  stage.
+ *  @param[in]  ns spent.
+ *  @param[ret]
+ *  @note Each stage may be timed by a different thread.
+ */
+void profiler_add_stage(PipelineStage stage, uint64_t ns);
+
+/** @brief Adds the latency of a complete angle, speed and torque cycle.
+ *  @param[in]  ns latency.
+ *  @param[in]  failed true when a stage returned NOK.
+ *  @param[ret]
+ *  @note Only one thread may add cycles.
+ */
+void profiler_add_cycle(uint64_t ns, bool failed);
+
+/** @brief Prints cycles/s, the time share of each stage and the cycle latency
+ * 	   quantiles of the run.
+ *  @param[in]  out stream to print to.
+ *  @param[in]  failures prints the failed cycle count as well.
+ *  @param[ret]
+ *  @note Pass failures only when the cycles were added with their failed flag.
+ */
+void profiler_report(FILE *out, bool failures);
+
+#endif /* PIPELINE_PROFILER_H_ */
@@ -0,0 +1,173 @@
+/** @file
+ *  @brief real-time memory file.
+ *  @description This module locks memory, pre-faults stacks and checks at runtime
+ *  		 that steady-state cycles neither allocate on the heap nor page fault.
+ */
+
+#define _GNU_SOURCE
+
+#include "Realtime_Memory.h"
+
+#include "Torque_Module.h"
+#include <malloc.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+
+static atomic_uint_fast64_t s_rt_allocations		=	0;
+static bool s_rt_enabled				=	false;
+
+static atomic_uint_fast64_t s_rt_cycles		=	0;
+static atomic_uint_fast64_t s_rt_allocating_cycles	=	0;
+static atomic_uint_fast64_t s_rt_faulting_cycles	=	0;
+
+#if RT_ALLOCATION_HOOKS
+/** The allocator entry points are interposed to count heap allocations; the
+ *  actual work is left to glibc. The aligned allocators (posix_memalign,
+ *  aligned_alloc, memalign) are not interposed and therefore not counted.
+ */
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t nmemb, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+
+void *malloc(size_t size)
+{
+	atomic_fetch_add_explicit(&s_rt_allocations, 1, memory_order_relaxed);
+	return __libc_malloc(size);
+}
+
+void *calloc(size_t nmemb, size_t size)
+{
+	atomic_fetch_add_explicit(&s_rt_allocations, 1, memory_order_relaxed);
+	return __libc_calloc(nmemb, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+	atomic_fetch_add_explicit(&s_rt_allocations, 1, memory_order_relaxed);
+	return __libc_realloc(ptr, size);
+}
+#endif
+
+static uint64_t get_thread_page_faults(void)
+{
+	struct rusage lv_usage;
+
+	if(getrusage(RUSAGE_THREAD, &lv_usage) != 0) {
+		return 0;
+	}
+	return (uint64_t)lv_usage.ru_minflt + (uint64_t)lv_usage.ru_majflt;
+}
+
+int rt_memory_init(void)
+/**
+ * Description: Locks all current and future memory and keeps freed heap memory
+ * 		in the process.
+ * Inputs:
+ * Output:
+ * return: 	OK / NOK
+ */
+{
+	int lvResult = OK;
+
+	s_rt_enabled = true;
+
+	(void)mallopt(M_TRIM_THRESHOLD, -1);
+	(void)mallopt(M_MMAP_MAX, 0);
+
+	if(mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+		printf("[RT] mlockall failed, continuing without locked memory\n");
+		lvResult = NOK;
+	} else {
+		printf("[RT] Memory locked\n");
+	}
+	#if !RT_ALLOCATION_HOOKS
+		printf("[RT] Heap allocations are not counted, build with -DRT_ALLOCATION_HOOKS=1\n");
+	#endif
+
+	rt_memory_prefault_stack();
+	return lvResult;
+}
+
+bool rt_memory_enabled(void)
+/**
+ * Description: Returns whether the real-time memory mode is enabled.
+ * Inputs:
+ * Output:
+ * return: 	true / false
+ */
+{
+	return s_rt_enabled;
+}
+
+void rt_memory_prefault_stack(void)
+/**
+ * Description: Touches the stack of the calling thread.
+ * Inputs:
+ * Output:
+ * return:
+ */
+{
+	volatile unsigned char lv_stack[RT_STACK_PREFAULT_SIZE];
+
+	memset((void*)lv_stack, 0, sizeof(lv_stack));
+}
+
+void rt_memory_begin_cycle(RtCycleProbe_t *outProbe)
+/**
+ * Description: Takes the allocation and page fault counters at the start of a cycle.
+ * Inputs:
+ * Output: 	outProbe
+ * return:
+ */
+{
+	outProbe->allocations	=	atomic_load_explicit(&s_rt_allocations, memory_order_relaxed);
+	outProbe->page_faults	=	get_thread_page_faults();
+}
+
+int rt_memory_end_cycle(const RtCycleProbe_t *inProbe, const char *stage, uint64_t cycle)
+/**
+ * Description: Reports allocations and page faults since rt_memory_begin_cycle().
+ * Inputs: 	inProbe
+ * 	: 	stage
+ * 	: 	cycle
+ * Output:
+ * return: 	OK / NOK
+ */
+{
+	uint64_t lv_Allocations	=	atomic_load_explicit(&s_rt_allocations, memory_order_relaxed) - inProbe->allocations;
+	uint64_t lv_PageFaults	=	get_thread_page_faults() - inProbe->page_faults;
+
+	if(cycle < RT_WARMUP_CYCLES) {
+		return OK;
+	}
+
+	atomic_fetch_add_explicit(&s_rt_cycles, 1, memory_order_relaxed);
+	if(lv_Allocations) {
+		atomic_fetch_add_explicit(&s_rt_allocating_cycles, 1, memory_order_relaxed);
+	}
+	if(lv_PageFaults) {
+		atomic_fetch_add_explicit(&s_rt_faulting_cycles, 1, memory_order_relaxed);
+	}
+	if(lv_Allocations || lv_PageFaults) {
+		printf("[RT] %s cycle %llu: %llu allocations, %llu page faults\n", stage, (unsigned long long)cycle,
+			   (unsigned long long)lv_Allocations, (unsigned long long)lv_PageFaults);
+		return NOK;
+	}
+	return OK;
+}
+
+void rt_memory_get_stats(RtMemoryStats_t *outStats)
+/**
+ * Description: Copies the steady-state check counters.
+ * Inputs:
+ * Output: 	outStats
+ * return:
+ */
+{
+	outStats->cycles		=	atomic_load_explicit(&s_rt_cycles, memory_order_relaxed);
+	outStats->allocating_cycles	=	atomic_load_explicit(&s_rt_allocating_cycles, memory_order_relaxed);
+	outStats->faulting_cycles	=	atomic_load_explicit(&s_rt_faulting_cycles, memory_order_relaxed);
+}
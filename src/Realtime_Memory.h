@@ -0,0 +1,92 @@
+/**
+ * @file
+ * @brief Header file for the real-time memory mode.
+ */
+
+#ifndef REALTIME_MEMORY_H_
+#define REALTIME_MEMORY_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/************************************************
+ *  Macro definitions used in real-time mode.
+ ***********************************************/
+#define RT_THREAD_STACK_SIZE		(256*1024)	// Bytes, explicit stack size of the calculator threads
+#define RT_STACK_PREFAULT_SIZE	(64*1024)	// Bytes of stack touched before the first cycle
+#define RT_WARMUP_CYCLES		3		// Cycles that may still allocate or fault (first pass)
+
+/** Off by default, as the hooks add an atomic increment to every allocation of the process.
+ *  Build with -DRT_ALLOCATION_HOOKS=1 to count heap allocations in real-time mode.
+ */
+#ifndef RT_ALLOCATION_HOOKS
+#define RT_ALLOCATION_HOOKS		0	// 1 - Counts malloc/calloc/realloc calls of the process
+#endif
+
+/************************************************
+ *  Structure definitions
+ ***********************************************/
+typedef struct {
+	uint64_t allocations;	// Heap allocations of the process when the cycle started
+	uint64_t page_faults;	// Minor + major page faults of the thread when the cycle started
+}RtCycleProbe_t;
+
+typedef struct {
+	uint64_t cycles;		// Steady-state cycles checked
+	uint64_t allocating_cycles;	// Steady-state cycles that allocated on the heap
+	uint64_t faulting_cycles;	// Steady-state cycles that caused page faults
+}RtMemoryStats_t;
+
+/************************************************
+ *  Function definitions
+ ***********************************************/
+
+/** @brief Locks all current and future memory and stops malloc from trimming or
+ * 	   mmap-ing, so memory obtained during init is never given back.
+ *  @param[in]
+ *  @param[ret] OK, NOK if memory could not be locked (e.g. missing privileges).
+ *  @note Real-time mode continues without the lock in that case.
+ */
+int rt_memory_init(void);
+
+/** @brief Returns whether rt_memory_init() was called.
+ *  @param[in]
+ *  @param[ret] true in real-time mode.
+ *  @note
+ */
+bool rt_memory_enabled(void);
+
+/** @brief Touches RT_STACK_PREFAULT_SIZE bytes of the calling thread's stack, so the
+ * 	   stack pages are mapped before the first cycle.
+ *  @param[in]
+ *  @param[ret]
+ *  @note
+ */
+void rt_memory_prefault_stack(void);
+
+/** @brief Takes the allocation and page fault counters at the start of a cycle.
+ *  @param[out] outProbe counters.
+ *  @param[ret]
+ *  @note
+ */
+void rt_memory_begin_cycle(RtCycleProbe_t *outProbe);
+
+/** @brief Compares the counters with those of rt_memory_begin_cycle(). Violations
+ * 	   are reported once RT_WARMUP_CYCLES cycles of the stage have passed.
+ *  @param[in]  inProbe counters from rt_memory_begin_cycle().
+ *  @param[in]  stage name used in the report.
+ *  @param[in]  cycle number of the stage, starting at 0.
+ *  @param[ret] OK, NOK if a steady-state cycle allocated or faulted.
+ *  @note Allocations are only counted with RT_ALLOCATION_HOOKS, for the whole process in
+ * 	   multi-threaded mode. posix_memalign(), aligned_alloc() and memalign() are not counted.
+ */
+int rt_memory_end_cycle(const RtCycleProbe_t *inProbe, const char *stage, uint64_t cycle);
+
+/** @brief Copies the steady-state check counters.
+ *  @param[out] outStats counters.
+ *  @param[ret]
+ *  @note
+ */
+void rt_memory_get_stats(RtMemoryStats_t *outStats);
+
+#endif /* REALTIME_MEMORY_H_ */
@@ -0,0 +1,117 @@
+/** @file
+ *  @brief torque cache file.
+ *  @description This module memoizes the torque stage on the quantized inputs
+ *  		 of the pedal map, so steady cruise does not recompute the same torque.
+ */
+
+#include "Torque_Cache.h"
+
+#include "Torque_Module.h"
+#include <stdio.h>
+
+typedef struct {
+	uint16_t tag;
+	signed char torque;
+}TorqueCacheEntry_t;
+
+static TorqueCacheEntry_t s_cache_entries[TORQUE_CACHE_SIZE]	=	{{0}};
+static uint16_t s_last_tag					=	0;
+static signed char s_last_torque				=	0;
+static TorqueCacheStats_t s_cache_stats			=	{0};
+
+static bool get_cache_tag(float angle, unsigned int speed, bool two_speed, uint16_t *outTag)
+/**
+ * Description: This function quantizes angle and speed exactly the way the torque
+ * 		functions do, so that equal tags always produce equal torque.
+ * Inputs: 	angle
+ * 	: 	speed
+ * 	: 	two_speed
+ * Output: 	outTag
+ * return: 	false if the inputs are outside the map and must not be cached
+ */
+{
+	float lv_Throttle = ((float)angle/MAX_ANGLE)*MAX_THROTTLE_POSSIBLE;
+
+	if(!(lv_Throttle >= 0) || lv_Throttle >= MAX_THROTTLE_DATA_COUNT || speed > MAX_POSSIBLE_SPEED) {
+		return false;
+	}
+
+	/** Two speed lookups only depend on Resting/Moving, not on the speed itself */
+	unsigned int lv_Speed_Key = two_speed ? (speed == SPEED_AT_REST ? Resting : Moving) : speed;
+
+	*outTag = TORQUE_CACHE_VALID_BIT | (two_speed ? TORQUE_CACHE_MODE_BIT : 0) | \
+			(lv_Speed_Key << TORQUE_CACHE_SPEED_SHIFT) | (unsigned int)lv_Throttle;
+	return true;
+}
+
+void torque_cache_reset(void)
+/**
+ * Description: Invalidates all cached torque values and clears the counters.
+ * Inputs:
+ * Output:
+ * return:
+ */
+{
+	for(unsigned int i = 0; i < TORQUE_CACHE_SIZE; i++) {
+		s_cache_entries[i].tag = 0;
+	}
+	s_last_tag = 0;
+	s_cache_stats.hits = s_cache_stats.misses = s_cache_stats.bypasses = 0;
+}
+
+signed char get_torque_cached(float angle, unsigned int speed, bool two_speed)
+/**
+ * Description: This function returns torque for the given angle and speed. The last
+ * 		value is checked first, then a direct-mapped table indexed by the
+ * 		quantized key; only on a miss the torque functions are evaluated.
+ * Inputs: 	angle
+ * 	: 	speed
+ * 	: 	two_speed
+ * Output:
+ * return: 	torque
+ */
+{
+	uint16_t lv_Tag = 0;
+
+	if(!get_cache_tag(angle, speed, two_speed, &lv_Tag)) {
+		s_cache_stats.bypasses++;
+		return two_speed ? get_torque_two_speed(angle, speed == SPEED_AT_REST ? Resting : Moving) : \
+				get_torque_rpm_based_speed(angle, speed);
+	}
+
+	if(lv_Tag == s_last_tag) {
+		s_cache_stats.hits++;
+		return s_last_torque;
+	}
+
+	TorqueCacheEntry_t *lv_Entry = &s_cache_entries[(lv_Tag ^ (lv_Tag >> TORQUE_CACHE_SPEED_SHIFT)) & TORQUE_CACHE_INDEX_MASK];
+
+	if(lv_Entry->tag == lv_Tag) {
+		s_cache_stats.hits++;
+	} else {
+		s_cache_stats.misses++;
+		lv_Entry->tag = lv_Tag;
+		lv_Entry->torque = two_speed ? get_torque_two_speed(angle, speed == SPEED_AT_REST ? Resting : Moving) : \
+					get_torque_rpm_based_speed(angle, speed);
+	}
+
+	#if DEBUG
+		printf("%s | tag:0x%04x torque:%d hits:%u misses:%u\n", __func__, lv_Tag, lv_Entry->torque,
+			   s_cache_stats.hits, s_cache_stats.misses);
+	#endif
+
+	s_last_tag = lv_Tag;
+	s_last_torque = lv_Entry->torque;
+	return s_last_torque;
+}
+
+void torque_cache_get_stats(TorqueCacheStats_t *outStats)
+/**
+ * Description: Copies the hit/miss counters of the torque cache.
+ * Inputs:
+ * Output: 	outStats
+ * return:
+ */
+{
+	*outStats = s_cache_stats;
+}
@@ -0,0 +1,62 @@
+/**
+ * @file
+ * @brief Header file for the memoizing torque stage.
+ */
+
+#ifndef TORQUE_CACHE_H_
+#define TORQUE_CACHE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/************************************************
+ *  Macro definitions used by the torque cache.
+ ***********************************************/
+#define TORQUE_CACHE_SIZE		64	// Number of direct-mapped entries, must be a power of 2
+#define TORQUE_CACHE_INDEX_MASK	(TORQUE_CACHE_SIZE-1)
+
+#define TORQUE_CACHE_VALID_BIT	0x8000	// Set in the tag of a populated entry
+#define TORQUE_CACHE_MODE_BIT	0x4000	// Set for two speed lookups
+#define TORQUE_CACHE_SPEED_SHIFT	7	// Throttle percent fits in the lower 7 bits
+
+/************************************************
+ *  Structure definitions
+ ***********************************************/
+typedef struct {
+	uint32_t hits;		// Served from the last value or the direct-mapped table
+	uint32_t misses;		// Evaluated by the torque functions and stored
+	uint32_t bypasses;	// Inputs outside the map, evaluated without caching
+}TorqueCacheStats_t;
+
+/************************************************
+ *  Function definitions
+ ***********************************************/
+
+/** @brief Invalidates all cached torque values and clears the counters.
+ * 	   Must be called whenever the torque tables are (re)initialized.
+ *  @param[in]
+ *  @param[ret]
+ *  @note
+ */
+void torque_cache_reset(void);
+
+/** @brief This function returns torque for the given angle and speed, reusing the
+ * 	   last result when the quantized (throttle percent, speed) key is unchanged.
+ * 	   The result is always identical to calling get_torque_two_speed() or
+ * 	   get_torque_rpm_based_speed() directly.
+ *  @param[in]  angle.
+ *  @param[in]  speed.
+ *  @param[in]  two_speed true selects get_torque_two_speed(), false get_torque_rpm_based_speed().
+ *  @param[ret] torque
+ *  @note
+ */
+signed char get_torque_cached(float angle, unsigned int speed, bool two_speed);
+
+/** @brief Copies the hit/miss counters of the torque cache.
+ *  @param[out] outStats counters since the last torque_cache_reset().
+ *  @param[ret]
+ *  @note
+ */
+void torque_cache_get_stats(TorqueCacheStats_t *outStats);
+
+#endif /* TORQUE_CACHE_H_ */
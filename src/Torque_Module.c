@@ -8,11 +8,14 @@
 #include "drivers/adc_driver/adc_driver.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
 static TorqueFiller_t s_torque_filler				=	{0};
-static float s_var_speed_torque_0_deg[MAX_POSSIBLE_SPEED]	=	{0.0};
+static float s_var_speed_torque_0_deg[MAX_POSSIBLE_SPEED+1]	=	{0.0};
 static adc_value_t s_adc_samples[ADC_NUM_CHANNELS][ADC_LPF_NR_OF_SAMPLES]	=	{{0.0}};
+static uint32_t s_adc_lpf_sum[ADC_NUM_CHANNELS]		=	{0};
+static uint16_t s_adc_lpf_pos[ADC_NUM_CHANNELS]		=	{0};
 
 int get_user_throttle_input(void)
 /**
@@ -53,8 +56,8 @@ static adc_value_t get_movingAvg(adc_channel_id_t inID, adc_value_t nextSample)
  * return:      adc_value_t
  */
 {
-	static uint32_t lv_Sum = 0;
-	static uint16_t adc_lpf_pos[ADC_NUM_CHANNELS] = {0};
+	uint32_t lv_Sum = s_adc_lpf_sum[inID];
+	uint16_t *adc_lpf_pos = s_adc_lpf_pos;
 
 	//Subtract the oldest number from the prev sum, add the new number
 	lv_Sum = lv_Sum - s_adc_samples[inID][adc_lpf_pos[inID]] + nextSample;
@@ -62,6 +65,8 @@ static adc_value_t get_movingAvg(adc_channel_id_t inID, adc_value_t nextSample)
 	//Assign the nextNum to the position in the array
 	s_adc_samples[inID][adc_lpf_pos[inID]] = nextSample;
 
+	s_adc_lpf_sum[inID] = lv_Sum;
+
 	adc_lpf_pos[inID]++;
 	if(adc_lpf_pos[inID] == ADC_LPF_NR_OF_SAMPLES) {
 			adc_lpf_pos[inID] = 0;
@@ -81,9 +86,9 @@ static adc_value_t get_movingAvg(adc_channel_id_t inID, adc_value_t nextSample)
 	return  lv_Mov_Avg;
 }
 
-adc_value_t calc_adc_value(adc_channel_id_t inID, float angle)
+adc_value_t calc_raw_adc_value(adc_channel_id_t inID, float angle)
 /**
- * Description: This function returns ADC value from specific channel
+ * Description: This function returns the unfiltered ADC value from specific channel
  * Inputs:      adc_channel_id_t (inID)
  * 	     :	    angle w.r.t applied throttle
  * output:
@@ -96,7 +101,19 @@ adc_value_t calc_adc_value(adc_channel_id_t inID, float angle)
 		printf("%s | ADC_CHANNEL:%d = %f => %u\n", __func__, inID, lv_ADC, (adc_value_t)(lv_ADC*ADC_MULTIPLIER));
 	#endif
 
-	return get_movingAvg(inID, (adc_value_t)(lv_ADC*ADC_MULTIPLIER));
+	return (adc_value_t)(lv_ADC*ADC_MULTIPLIER);
+}
+
+adc_value_t calc_adc_value(adc_channel_id_t inID, float angle)
+/**
+ * Description: This function returns ADC value from specific channel
+ * Inputs:      adc_channel_id_t (inID)
+ * 	     :	    angle w.r.t applied throttle
+ * output:
+ * return:      adc_value_t
+ */
+{
+	return get_movingAvg(inID, calc_raw_adc_value(inID, angle));
 }
 
 unsigned int get_rotation_timer_count(void)
@@ -222,8 +239,6 @@ void init_two_speed_torque_data(void)
 {
 	float Torque_Step_Per_Angle[_SpeedLevels] = {0};
 
-	printf("Filling torque structure for distinct two speed system\n");
-
 	Torque_Step_Per_Angle[Resting]	=	(float)(TORQUE_AT_MAX_ANGLE-TORQUE_AT_REST_0_DEG)/MAX_THROTTLE_POSSIBLE;
 	Torque_Step_Per_Angle[Moving] 	= 	(float)(TORQUE_AT_MAX_ANGLE-TORQUE_AT_50KM_0_DEG)/MAX_THROTTLE_POSSIBLE;
 
@@ -259,3 +274,53 @@ void init_two_speed_torque_data(void)
 		#endif
 	}
 }
+
+void torque_module_get_state(TorqueModuleState_t *outState)
+/**
+ * Description: This function copies the filter and torque table state.
+ * Inputs:
+ * Output: 	outState
+ * return:
+ */
+{
+	memcpy(outState->adc_samples, s_adc_samples, sizeof(s_adc_samples));
+	memcpy(outState->adc_lpf_pos, s_adc_lpf_pos, sizeof(s_adc_lpf_pos));
+	memcpy(outState->adc_lpf_sum, s_adc_lpf_sum, sizeof(s_adc_lpf_sum));
+	outState->torque_filler		=	s_torque_filler;
+	memcpy(outState->var_speed_torque_0_deg, s_var_speed_torque_0_deg, sizeof(s_var_speed_torque_0_deg));
+}
+
+int torque_module_set_state(const TorqueModuleState_t *inState)
+/**
+ * Description: This function restores the filter state after checking that it is
+ * 		consistent and that its torque tables match the initialized ones.
+ * Inputs: 	inState
+ * Output:
+ * return: 	OK / NOK
+ */
+{
+	/** A state saved with other tables would change the torque output */
+	if(memcmp(&inState->torque_filler, &s_torque_filler, sizeof(s_torque_filler)) != 0 || \
+	   memcmp(inState->var_speed_torque_0_deg, s_var_speed_torque_0_deg, sizeof(s_var_speed_torque_0_deg)) != 0) {
+		return NOK;
+	}
+
+	for(unsigned int ch = 0; ch < ADC_NUM_CHANNELS; ch++) {
+		uint32_t lv_Sum = 0;
+
+		if(inState->adc_lpf_pos[ch] >= ADC_LPF_NR_OF_SAMPLES) {
+			return NOK;
+		}
+		for(unsigned int i = 0; i < ADC_LPF_NR_OF_SAMPLES; i++) {
+			lv_Sum += inState->adc_samples[ch][i];
+		}
+		if(lv_Sum != inState->adc_lpf_sum[ch]) {
+			return NOK;
+		}
+	}
+
+	memcpy(s_adc_samples, inState->adc_samples, sizeof(s_adc_samples));
+	memcpy(s_adc_lpf_pos, inState->adc_lpf_pos, sizeof(s_adc_lpf_pos));
+	memcpy(s_adc_lpf_sum, inState->adc_lpf_sum, sizeof(s_adc_lpf_sum));
+	return OK;
+}
@@ -83,6 +83,14 @@ typedef struct {
 	signed char pvMovingTorqueFiller[MAX_THROTTLE_DATA_COUNT];
 }TorqueFiller_t;
 
+typedef struct {
+	adc_value_t adc_samples[ADC_NUM_CHANNELS][ADC_LPF_NR_OF_SAMPLES];	// Moving average window
+	uint16_t adc_lpf_pos[ADC_NUM_CHANNELS];				// Next sample position
+	uint32_t adc_lpf_sum[ADC_NUM_CHANNELS];				// Running sum of the window
+	TorqueFiller_t torque_filler;						// Two speed torque table
+	float var_speed_torque_0_deg[MAX_POSSIBLE_SPEED+1];			// 0 degree torque per speed
+}TorqueModuleState_t;
+
 /************************************************
  *  Global variable declarations
  ***********************************************/
@@ -131,6 +139,14 @@ int get_user_throttle_input(void);
  */
 float get_pedal_angle(unsigned int throttle_applied);
 
+/** @brief This function returns the unfiltered ADC value from specific channel.
+ *  @param[in]  adc_channel_id_t.
+ *  @param[in]  angle w.r.t applied throttle.
+ *  @param[ret] adc_value_t
+ *  @note calc_adc_value() passes this value through the moving average filter.
+ */
+adc_value_t calc_raw_adc_value(adc_channel_id_t inID, float angle);
+
 /** @brief This function returns ADC value from specific channel.
  *  @param[in]  adc_channel_id_t.
  *  @param[in]  angle w.r.t applied throttle.
@@ -170,4 +186,20 @@ signed char get_torque_rpm_based_speed(float angle, unsigned int speed);
  */
 void init_two_speed_torque_data(void);
 
+/** @brief This function copies the moving average filter and torque table state,
+ * 	   e.g. to checkpoint it.
+ *  @param[out] outState
+ *  @param[ret]
+ *  @note
+ */
+void torque_module_get_state(TorqueModuleState_t *outState);
+
+/** @brief This function restores the filter state from torque_module_get_state().
+ *  @param[in]  inState
+ *  @param[ret] OK, NOK if the state is inconsistent or its torque tables differ from
+ * 	   the initialized ones (nothing is restored then).
+ *  @note init_two_speed_torque_data() has to be called first.
+ */
+int torque_module_set_state(const TorqueModuleState_t *inState);
+
 #endif /* TORQUE_MODULE_H_ */
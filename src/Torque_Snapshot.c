@@ -0,0 +1,282 @@
+/** @file
+ *  @brief torque snapshot file.
+ *  @description This module publishes the latest (speed, angle, torque) tuple with a
+ *  		 seqlock, so dashboards, loggers and diagnostics get a consistent tuple
+ *  		 without ever blocking the torque writer.
+ */
+
+#define _GNU_SOURCE	// pthread_attr_setaffinity_np / pthread_setaffinity_np
+
+#include "Torque_Snapshot.h"
+
+#include "Torque_Module.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/** All fields are accessed atomically so concurrent reads are well defined; the
+ *  sequence number is odd while the writer is updating them.
+ */
+typedef struct {
+	_Alignas(SNAPSHOT_CACHE_LINE_SIZE) atomic_uint sequence;
+	atomic_uint cycle;
+	atomic_uint speed;
+	atomic_uint angle_bits;
+	atomic_int torque;
+}TorqueSeqlock_t;
+
+typedef struct {
+	_Alignas(SNAPSHOT_CACHE_LINE_SIZE) unsigned long reads;
+	unsigned long retries;
+	unsigned long torn;
+}SnapshotReaderStats_t;
+
+static TorqueSeqlock_t s_snapshot					=	{0};
+
+static atomic_bool s_bench_running					=	false;
+static SnapshotReaderStats_t s_bench_readers[SNAPSHOT_BENCH_MAX_READERS]	=	{{0}};
+static uint64_t s_bench_latency[SNAPSHOT_BENCH_LATENCY_BINS]			=	{0};
+
+void torque_snapshot_publish(unsigned int speed, float angle, signed char torque)
+/**
+ * Description: Publishes a new tuple; the sequence is odd while the fields change.
+ * Inputs: 	speed
+ * 	: 	angle
+ * 	: 	torque
+ * Output:
+ * return:
+ */
+{
+	unsigned int lv_Sequence = atomic_load_explicit(&s_snapshot.sequence, memory_order_relaxed);
+	uint32_t lv_AngleBits = 0;
+
+	memcpy(&lv_AngleBits, &angle, sizeof(lv_AngleBits));
+
+	atomic_store_explicit(&s_snapshot.sequence, lv_Sequence + 1, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+
+	atomic_store_explicit(&s_snapshot.cycle, atomic_load_explicit(&s_snapshot.cycle, memory_order_relaxed) + 1, memory_order_relaxed);
+	atomic_store_explicit(&s_snapshot.speed, speed, memory_order_relaxed);
+	atomic_store_explicit(&s_snapshot.angle_bits, lv_AngleBits, memory_order_relaxed);
+	atomic_store_explicit(&s_snapshot.torque, torque, memory_order_relaxed);
+
+	atomic_store_explicit(&s_snapshot.sequence, lv_Sequence + 2, memory_order_release);
+}
+
+unsigned int torque_snapshot_read(TorqueSnapshot_t *outSnapshot)
+/**
+ * Description: Reads the latest tuple, retrying while a publish is in progress
+ * 		or happened during the read.
+ * Inputs:
+ * Output: 	outSnapshot
+ * return: 	number of retries
+ */
+{
+	unsigned int lv_Retries = 0;
+
+	while(1) {
+		unsigned int lv_Begin = atomic_load_explicit(&s_snapshot.sequence, memory_order_acquire);
+
+		if((lv_Begin & 1) == 0) {
+			uint32_t lv_AngleBits = 0;
+
+			outSnapshot->cycle	=	atomic_load_explicit(&s_snapshot.cycle, memory_order_relaxed);
+			outSnapshot->speed	=	atomic_load_explicit(&s_snapshot.speed, memory_order_relaxed);
+			lv_AngleBits		=	atomic_load_explicit(&s_snapshot.angle_bits, memory_order_relaxed);
+			outSnapshot->torque	=	(signed char)atomic_load_explicit(&s_snapshot.torque, memory_order_relaxed);
+
+			atomic_thread_fence(memory_order_acquire);
+			if(atomic_load_explicit(&s_snapshot.sequence, memory_order_relaxed) == lv_Begin) {
+				memcpy(&outSnapshot->angle, &lv_AngleBits, sizeof(outSnapshot->angle));
+				return lv_Retries;
+			}
+		}
+		lv_Retries++;
+	}
+}
+
+static void* Snapshot_Reader_Thread(void *args)
+/**
+ * Description: Benchmark reader, spins on the snapshot and checks that every tuple
+ * 		is consistent. The writer publishes speed = i, angle = i % MAX_ANGLE and
+ * 		torque = i % TORQUE_AT_MAX_ANGLE, starting at i = 0 with a reset cycle,
+ * 		so every consistent tuple also has cycle = i + 1.
+ * Inputs: 	args (SnapshotReaderStats_t)
+ * Output:
+ * return:
+ */
+{
+	SnapshotReaderStats_t *lv_Stats = (SnapshotReaderStats_t*)args;
+	TorqueSnapshot_t lv_Snapshot;
+
+	while(atomic_load_explicit(&s_bench_running, memory_order_relaxed)) {
+		lv_Stats->retries += torque_snapshot_read(&lv_Snapshot);
+		lv_Stats->reads++;
+		if(lv_Snapshot.cycle != lv_Snapshot.speed + 1 || \
+		   lv_Snapshot.angle != (float)(lv_Snapshot.speed % MAX_ANGLE) || \
+		   lv_Snapshot.torque != (signed char)(lv_Snapshot.speed % TORQUE_AT_MAX_ANGLE)) {
+			lv_Stats->torn++;
+		}
+	}
+	return NULL;
+}
+
+static double get_elapsed_ns(const struct timespec *inStart)
+{
+	struct timespec lv_now;
+	clock_gettime(CLOCK_MONOTONIC, &lv_now);
+	return (lv_now.tv_sec - inStart->tv_sec) * 1e9 + (lv_now.tv_nsec - inStart->tv_nsec);
+}
+
+static int get_nth_cpu(const cpu_set_t *inSet, unsigned int n)
+/**
+ * Description: Returns the n-th CPU of a CPU set, counting from 0.
+ * Inputs: 	inSet
+ * 	: 	n
+ * Output:
+ * return: 	CPU number, -1 if the set has fewer CPUs
+ */
+{
+	for(int lv_Cpu = 0; lv_Cpu < CPU_SETSIZE; lv_Cpu++) {
+		if(CPU_ISSET(lv_Cpu, inSet) && n-- == 0) {
+			return lv_Cpu;
+		}
+	}
+	return -1;
+}
+
+static uint64_t get_latency_quantile(uint64_t samples, double q)
+/**
+ * Description: Returns the latency below which a fraction q of the timed publishes lie.
+ * Inputs: 	samples
+ * 	: 	q
+ * Output:
+ * return: 	latency in ns, SNAPSHOT_BENCH_LATENCY_BINS - 1 means that or more
+ */
+{
+	uint64_t lv_Rank = (uint64_t)(q * (samples - 1) + 0.5), lv_Count = 0;
+
+	for(unsigned int b = 0; b < SNAPSHOT_BENCH_LATENCY_BINS; b++) {
+		lv_Count += s_bench_latency[b];
+		if(lv_Count > lv_Rank) {
+			return b;
+		}
+	}
+	return SNAPSHOT_BENCH_LATENCY_BINS - 1;
+}
+
+int torque_snapshot_benchmark(unsigned int max_readers)
+/**
+ * Description: Runs 1 writer against 0 up to max_readers readers (doubling each round),
+ * 		each pinned to its own CPU, and prints the mean publish cost of the writer
+ * 		and the percentiles of individually timed publishes. Reader counts that do
+ * 		not fit next to the writer on the available CPUs are skipped.
+ * Inputs: 	max_readers
+ * Output:
+ * return: 	OK / NOK, NOK also when fewer than two reader counts could be measured
+ */
+{
+	int lvResult = OK;
+	unsigned int lv_Measured = 0;
+	pthread_t lv_readers[SNAPSHOT_BENCH_MAX_READERS];
+	cpu_set_t lv_Allowed, lv_Cpu;
+	pthread_attr_t lv_Attr;
+
+	if(max_readers > SNAPSHOT_BENCH_MAX_READERS) {
+		max_readers = SNAPSHOT_BENCH_MAX_READERS;
+	}
+	if(pthread_getaffinity_np(pthread_self(), sizeof(lv_Allowed), &lv_Allowed) != 0) {
+		printf("Could not get the CPU affinity\n");
+		return NOK;
+	}
+
+	/** The writer keeps the first allowed CPU, reader r gets the (r + 1)-th */
+	CPU_ZERO(&lv_Cpu);
+	CPU_SET(get_nth_cpu(&lv_Allowed, 0), &lv_Cpu);
+	(void)pthread_setaffinity_np(pthread_self(), sizeof(lv_Cpu), &lv_Cpu);
+
+	printf("%-8s %12s %8s %8s %8s %14s %10s %6s\n", "readers", "mean_ns/pub", "p50_ns", "p99_ns", "max_ns",
+		   "reads/s", "retries", "torn");
+
+	for(unsigned int lv_Readers = 0; lv_Readers <= max_readers; lv_Readers = lv_Readers ? lv_Readers * 2 : 1) {
+		double lv_Total_ns = 0.0;
+		uint64_t lv_Max_ns = 0;
+		unsigned long lv_Reads = 0, lv_Retries = 0, lv_Torn = 0;
+		struct timespec lv_Start, lv_Begin, lv_End;
+		unsigned int lv_Started = 0;
+
+		if(lv_Readers >= (unsigned int)CPU_COUNT(&lv_Allowed)) {
+			printf("%-8u skipped, needs %u CPUs and %d are available\n", lv_Readers, lv_Readers + 1, CPU_COUNT(&lv_Allowed));
+			continue;
+		}
+
+		memset(s_bench_readers, 0, sizeof(s_bench_readers));
+		memset(s_bench_latency, 0, sizeof(s_bench_latency));
+		atomic_store(&s_snapshot.cycle, 0);
+		torque_snapshot_publish(0, 0.0, 0);
+		atomic_store(&s_bench_running, true);
+
+		for(unsigned int r = 0; r < lv_Readers; r++) {
+			CPU_ZERO(&lv_Cpu);
+			CPU_SET(get_nth_cpu(&lv_Allowed, r + 1), &lv_Cpu);
+			(void)pthread_attr_init(&lv_Attr);
+			(void)pthread_attr_setaffinity_np(&lv_Attr, sizeof(lv_Cpu), &lv_Cpu);
+			if(pthread_create(&lv_readers[r], &lv_Attr, Snapshot_Reader_Thread, &s_bench_readers[r]) == 0) {
+				lv_Started++;
+			}
+			(void)pthread_attr_destroy(&lv_Attr);
+		}
+
+		/** Mean cost from timed batches, so the clock reads do not add to it */
+		for(uint32_t lv_Cycle = 1; lv_Cycle <= SNAPSHOT_BENCH_PUBLISHES; lv_Cycle += SNAPSHOT_BENCH_BATCH) {
+			clock_gettime(CLOCK_MONOTONIC, &lv_Start);
+			for(uint32_t i = lv_Cycle; i < lv_Cycle + SNAPSHOT_BENCH_BATCH; i++) {
+				torque_snapshot_publish(i, (float)(i % MAX_ANGLE), (signed char)(i % TORQUE_AT_MAX_ANGLE));
+			}
+			lv_Total_ns += get_elapsed_ns(&lv_Start);
+		}
+
+		/** Percentiles from individually timed publishes, these include one clock read */
+		for(uint32_t i = SNAPSHOT_BENCH_PUBLISHES + 1; i <= SNAPSHOT_BENCH_PUBLISHES + SNAPSHOT_BENCH_TIMED; i++) {
+			clock_gettime(CLOCK_MONOTONIC, &lv_Begin);
+			torque_snapshot_publish(i, (float)(i % MAX_ANGLE), (signed char)(i % TORQUE_AT_MAX_ANGLE));
+			clock_gettime(CLOCK_MONOTONIC, &lv_End);
+
+			uint64_t lv_ns = (uint64_t)((lv_End.tv_sec - lv_Begin.tv_sec) * 1000000000ll + (lv_End.tv_nsec - lv_Begin.tv_nsec));
+			s_bench_latency[lv_ns < SNAPSHOT_BENCH_LATENCY_BINS ? lv_ns : SNAPSHOT_BENCH_LATENCY_BINS - 1]++;
+			if(lv_ns > lv_Max_ns) {
+				lv_Max_ns = lv_ns;
+			}
+		}
+
+		atomic_store(&s_bench_running, false);
+		for(unsigned int r = 0; r < lv_Started; r++) {
+			(void)pthread_join(lv_readers[r], NULL);
+			lv_Reads += s_bench_readers[r].reads;
+			lv_Retries += s_bench_readers[r].retries;
+			lv_Torn += s_bench_readers[r].torn;
+		}
+
+		printf("%-8u %12.2f %8llu %8llu %8llu %14.0f %10lu %6lu\n", lv_Readers, lv_Total_ns / SNAPSHOT_BENCH_PUBLISHES,
+			   (unsigned long long)get_latency_quantile(SNAPSHOT_BENCH_TIMED, 0.50),
+			   (unsigned long long)get_latency_quantile(SNAPSHOT_BENCH_TIMED, 0.99),
+			   (unsigned long long)lv_Max_ns, lv_Reads / (lv_Total_ns / 1e9), lv_Retries, lv_Torn);
+
+		if(lv_Torn || lv_Started != lv_Readers) {
+			lvResult = NOK;
+		}
+		lv_Measured++;
+	}
+
+	/** One row has nothing to compare the reader impact against */
+	if(lv_Measured < 2) {
+		printf("Reader impact not measured, only %u reader count(s) fit on %d CPUs\n", lv_Measured, CPU_COUNT(&lv_Allowed));
+		lvResult = NOK;
+	}
+
+	(void)pthread_setaffinity_np(pthread_self(), sizeof(lv_Allowed), &lv_Allowed);
+	return lvResult;
+}
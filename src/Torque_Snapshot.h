@@ -0,0 +1,65 @@
+/**
+ * @file
+ * @brief Header file for the seqlock published (speed, angle, torque) snapshot.
+ */
+
+#ifndef TORQUE_SNAPSHOT_H_
+#define TORQUE_SNAPSHOT_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/************************************************
+ *  Macro definitions used by the snapshot.
+ ***********************************************/
+#define SNAPSHOT_CACHE_LINE_SIZE	64
+
+#define SNAPSHOT_BENCH_MAX_READERS	8
+#define SNAPSHOT_BENCH_PUBLISHES	1000000
+#define SNAPSHOT_BENCH_BATCH		1000	// Publishes per timed batch
+#define SNAPSHOT_BENCH_TIMED		100000	// Individually timed publishes for the percentiles
+#define SNAPSHOT_BENCH_LATENCY_BINS	4096	// 1 ns bins, the last one collects everything above
+
+/************************************************
+ *  Structure definitions
+ ***********************************************/
+typedef struct {
+	uint32_t cycle;		// Incremented by the writer with every publish
+	unsigned int speed;	// Km/h
+	float angle;		// Degrees
+	signed char torque;	// Newton Meter
+}TorqueSnapshot_t;
+
+/************************************************
+ *  Function definitions
+ ***********************************************/
+
+/** @brief Publishes a new (speed, angle, torque) tuple. Never blocks.
+ *  @param[in]  speed.
+ *  @param[in]  angle.
+ *  @param[in]  torque.
+ *  @param[ret]
+ *  @note Only one writer may publish at a time.
+ */
+void torque_snapshot_publish(unsigned int speed, float angle, signed char torque);
+
+/** @brief Reads the latest published tuple. Retries while the writer is publishing,
+ * 	   so the returned tuple is always consistent. Any number of readers may read
+ * 	   concurrently without blocking the writer.
+ *  @param[out] outSnapshot latest tuple, all zero before the first publish.
+ *  @param[ret] number of retries needed.
+ *  @note
+ */
+unsigned int torque_snapshot_read(TorqueSnapshot_t *outSnapshot);
+
+/** @brief Measures writer publish latency with 0 up to max_readers concurrently
+ * 	   spinning readers, and prints the results.
+ *  @param[in]  max_readers, limited to SNAPSHOT_BENCH_MAX_READERS.
+ *  @param[ret] OK / NOK if a reader observed an inconsistent tuple.
+ *  @note The writer and every reader are pinned to their own CPU, reader counts
+ * 	   that need more CPUs than available are skipped. With fewer than two
+ * 	   measured reader counts the result is reported as not measured and NOK.
+ */
+int torque_snapshot_benchmark(unsigned int max_readers);
+
+#endif /* TORQUE_SNAPSHOT_H_ */
@@ -0,0 +1,92 @@
+/** @file
+ *  @brief torque split file.
+ *  @description This module splits the pedal map torque over several in-wheel motors
+ *  		 and limits the command of each motor in one pass over all lanes.
+ */
+
+#include "Torque_Split.h"
+
+#include "Torque_Module.h"
+
+static TorqueSplit_t s_torque_split			=	{{1.0f}, {TORQUE_AT_MAX_ANGLE}, {-TORQUE_AT_50KM_0_DEG}, {0.0f}};
+static unsigned int s_motor_count			=	SPLIT_DEFAULT_MOTORS;
+
+int torque_split_configure(unsigned int motor_count, const float *ratios,
+			   const float *max_drive, const float *max_regen)
+/**
+ * Description: Configures the motors, unused lanes get ratio and limits 0 so
+ * 		they always command 0 Newton Meter.
+ * Inputs: 	motor_count
+ * 	: 	ratios
+ * 	: 	max_drive
+ * 	: 	max_regen
+ * Output:
+ * return: 	OK / NOK
+ */
+{
+	float lv_Sum = 0.0f;
+
+	if(motor_count == 0 || motor_count > SPLIT_MAX_MOTORS) {
+		return NOK;
+	}
+	for(unsigned int i = 0; i < motor_count; i++) {
+		float lv_Ratio = ratios ? ratios[i] : 1.0f;
+		if(!(lv_Ratio >= 0.0f)) {
+			return NOK;
+		}
+		lv_Sum += lv_Ratio;
+	}
+	if(!(lv_Sum > 0.0f)) {
+		return NOK;
+	}
+
+	for(unsigned int i = 0; i < SPLIT_MAX_MOTORS; i++) {
+		if(i < motor_count) {
+			float lv_Ratio = (ratios ? ratios[i] : 1.0f) / lv_Sum;
+
+			s_torque_split.ratio[i]	=	lv_Ratio;
+			s_torque_split.max_drive[i]	=	max_drive ? max_drive[i] : lv_Ratio * TORQUE_AT_MAX_ANGLE;
+			s_torque_split.max_regen[i]	=	max_regen ? max_regen[i] : lv_Ratio * -TORQUE_AT_50KM_0_DEG;
+		} else {
+			s_torque_split.ratio[i] = s_torque_split.max_drive[i] = s_torque_split.max_regen[i] = 0.0f;
+		}
+		s_torque_split.command[i] = 0.0f;
+	}
+	s_motor_count = motor_count;
+	return OK;
+}
+
+unsigned int torque_split_motor_count(void)
+/**
+ * Description: Returns the configured number of motors.
+ * Inputs:
+ * Output:
+ * return: 	motor count
+ */
+{
+	return s_motor_count;
+}
+
+const float* torque_split_compute(signed char torque)
+/**
+ * Description: Splits the torque over all SPLIT_MAX_MOTORS lanes and clamps each
+ * 		command to [-max_regen, max_drive]. The fixed trip count and the
+ * 		branch free clamps let the compiler vectorize the loop.
+ * Inputs: 	torque
+ * Output:
+ * return: 	motor commands
+ */
+{
+	TorqueSplit_t *lv_Split = &s_torque_split;
+	float lv_Torque = torque;
+
+	for(unsigned int i = 0; i < SPLIT_MAX_MOTORS; i++) {
+		float lv_Command = lv_Torque * lv_Split->ratio[i];
+		float lv_Min = -lv_Split->max_regen[i];
+
+		lv_Command = lv_Command > lv_Split->max_drive[i] ? lv_Split->max_drive[i] : lv_Command;
+		lv_Command = lv_Command < lv_Min ? lv_Min : lv_Command;
+		lv_Split->command[i] = lv_Command;
+	}
+	return lv_Split->command;
+}
@@ -0,0 +1,55 @@
+/**
+ * @file
+ * @brief Header file for the multi-motor torque split.
+ */
+
+#ifndef TORQUE_SPLIT_H_
+#define TORQUE_SPLIT_H_
+
+/************************************************
+ *  Macro definitions used by the torque split.
+ ***********************************************/
+#define SPLIT_MAX_MOTORS		8	// Lanes of the split, unused lanes have ratio and limits 0
+#define SPLIT_DEFAULT_MOTORS		1
+
+/************************************************
+ *  Structure definitions
+ ***********************************************/
+/** Structure of arrays, so the split is a single pass the compiler can vectorize */
+typedef struct {
+	float ratio[SPLIT_MAX_MOTORS];		// Share of the pedal map torque, sums up to 1
+	float max_drive[SPLIT_MAX_MOTORS];	// Newton Meter, upper limit of the command
+	float max_regen[SPLIT_MAX_MOTORS];	// Newton Meter, magnitude of the lower limit
+	float command[SPLIT_MAX_MOTORS];	// Newton Meter, output of the last split
+}TorqueSplit_t;
+
+/************************************************
+ *  Function definitions
+ ***********************************************/
+
+/** @brief Configures the motors. Ratios are normalized to sum up to 1.
+ *  @param[in]  motor_count between 1 and SPLIT_MAX_MOTORS.
+ *  @param[in]  ratios motor_count split ratios, NULL for an equal split.
+ *  @param[in]  max_drive motor_count drive limits, NULL for ratio * TORQUE_AT_MAX_ANGLE.
+ *  @param[in]  max_regen motor_count regen limits, NULL for ratio * -TORQUE_AT_50KM_0_DEG.
+ *  @param[ret] OK / NOK on an invalid motor count or ratios.
+ *  @note The previous configuration is kept on NOK.
+ */
+int torque_split_configure(unsigned int motor_count, const float *ratios,
+			   const float *max_drive, const float *max_regen);
+
+/** @brief Returns the configured number of motors.
+ *  @param[in]
+ *  @param[ret] motor count
+ *  @note
+ */
+unsigned int torque_split_motor_count(void);
+
+/** @brief Splits the pedal map torque over all motors and limits each command.
+ *  @param[in]  torque from the pedal map.
+ *  @param[ret] contiguous array of torque_split_motor_count() commands, valid until the next call.
+ *  @note
+ */
+const float* torque_split_compute(signed char torque);
+
+#endif /* TORQUE_SPLIT_H_ */
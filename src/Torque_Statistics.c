@@ -0,0 +1,135 @@
+/** @file
+ *  @brief torque statistics file.
+ *  @description This module keeps constant memory statistics of the commanded torque
+ *  		 per speed and throttle bin, so long drive sessions can be summarized
+ *  		 without storing raw samples.
+ */
+
+#include "Torque_Statistics.h"
+
+static TorqueStatsCell_t s_stats_cells[STATS_SPEED_BINS][STATS_THROTTLE_BINS]	=	{{{0}}};
+static uint64_t s_stats_rejected								=	0;
+
+void torque_stats_reset(void)
+/**
+ * Description: Clears all cells.
+ * Inputs:
+ * Output:
+ * return:
+ */
+{
+	for(unsigned int s = 0; s < STATS_SPEED_BINS; s++) {
+		for(unsigned int t = 0; t < STATS_THROTTLE_BINS; t++) {
+			TorqueStatsCell_t *lv_Cell = &s_stats_cells[s][t];
+
+			lv_Cell->count = 0;
+			lv_Cell->sum = 0;
+			for(unsigned int b = 0; b < STATS_TORQUE_BINS; b++) {
+				lv_Cell->histogram[b] = 0;
+			}
+		}
+	}
+	s_stats_rejected = 0;
+}
+
+void torque_stats_add(unsigned int speed, float angle, signed char torque)
+/**
+ * Description: Adds a commanded torque to the cell of its speed and throttle bin.
+ * Inputs: 	speed
+ * 	: 	angle
+ * 	: 	torque
+ * Output:
+ * return:
+ */
+{
+	float lv_Throttle = ((float)angle/MAX_ANGLE)*MAX_THROTTLE_POSSIBLE;
+
+	if(!(lv_Throttle >= 0) || lv_Throttle > MAX_THROTTLE_POSSIBLE) {
+		s_stats_rejected++;
+		return;
+	}
+
+	unsigned int lv_Speed_Bin = speed > MAX_POSSIBLE_SPEED ? STATS_SPEED_BINS - 1 : speed / STATS_SPEED_BIN_WIDTH;
+	TorqueStatsCell_t *lv_Cell = &s_stats_cells[lv_Speed_Bin][(unsigned int)lv_Throttle / STATS_THROTTLE_BIN_WIDTH];
+
+	int lv_Torque_Bin = torque < STATS_TORQUE_MIN ? 0 : (torque > STATS_TORQUE_MAX ? STATS_TORQUE_BINS - 1 : torque - STATS_TORQUE_MIN);
+
+	if(lv_Cell->count == 0 || torque < lv_Cell->min) {
+		lv_Cell->min = torque;
+	}
+	if(lv_Cell->count == 0 || torque > lv_Cell->max) {
+		lv_Cell->max = torque;
+	}
+	lv_Cell->count++;
+	lv_Cell->sum += torque;
+	lv_Cell->histogram[lv_Torque_Bin]++;
+}
+
+const TorqueStatsCell_t* torque_stats_get_cell(unsigned int speed_bin, unsigned int throttle_bin)
+/**
+ * Description: Returns the cell of a speed and throttle bin.
+ * Inputs: 	speed_bin
+ * 	: 	throttle_bin
+ * Output:
+ * return: 	cell or NULL
+ */
+{
+	if(speed_bin >= STATS_SPEED_BINS || throttle_bin >= STATS_THROTTLE_BINS) {
+		return NULL;
+	}
+	return &s_stats_cells[speed_bin][throttle_bin];
+}
+
+signed char torque_stats_quantile(const TorqueStatsCell_t *cell, float quantile)
+/**
+ * Description: Walks the histogram up to the requested rank.
+ * Inputs: 	cell
+ * 	: 	quantile
+ * Output:
+ * return: 	torque
+ */
+{
+	if(cell->count == 0) {
+		return 0;
+	}
+
+	uint64_t lv_Rank = (uint64_t)((double)quantile * (cell->count - 1) + 0.5) + 1;
+	uint64_t lv_Seen = 0;
+
+	for(unsigned int b = 0; b < STATS_TORQUE_BINS; b++) {
+		lv_Seen += cell->histogram[b];
+		if(lv_Seen >= lv_Rank) {
+			return (signed char)(b + STATS_TORQUE_MIN);
+		}
+	}
+	return cell->max;
+}
+
+void torque_stats_dump(FILE *out)
+/**
+ * Description: Prints count, min, max, mean and quantiles of all non-empty cells.
+ * Inputs: 	out
+ * Output:
+ * return:
+ */
+{
+	fprintf(out, "%-11s %-13s %10s %5s %5s %8s %5s %5s %5s\n", "speed_km/h", "throttle_%",
+			"count", "min", "max", "mean", "p50", "p90", "p99");
+
+	for(unsigned int s = 0; s < STATS_SPEED_BINS; s++) {
+		for(unsigned int t = 0; t < STATS_THROTTLE_BINS; t++) {
+			const TorqueStatsCell_t *lv_Cell = &s_stats_cells[s][t];
+
+			if(lv_Cell->count == 0) {
+				continue;
+			}
+			fprintf(out, "%3u-%-7u %3u-%-9u %10llu %5d %5d %8.2f %5d %5d %5d\n",
+					s * STATS_SPEED_BIN_WIDTH, s * STATS_SPEED_BIN_WIDTH + STATS_SPEED_BIN_WIDTH - 1,
+					t * STATS_THROTTLE_BIN_WIDTH, t * STATS_THROTTLE_BIN_WIDTH + STATS_THROTTLE_BIN_WIDTH - 1,
+					(unsigned long long)lv_Cell->count, lv_Cell->min, lv_Cell->max, (double)lv_Cell->sum / lv_Cell->count,
+					torque_stats_quantile(lv_Cell, 0.5), torque_stats_quantile(lv_Cell, 0.9),
+					torque_stats_quantile(lv_Cell, 0.99));
+		}
+	}
+	fprintf(out, "Rejected samples: %llu\n", (unsigned long long)s_stats_rejected);
+}
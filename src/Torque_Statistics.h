@@ -0,0 +1,82 @@
+/**
+ * @file
+ * @brief Header file for the streaming torque statistics.
+ */
+
+#ifndef TORQUE_STATISTICS_H_
+#define TORQUE_STATISTICS_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include "Torque_Module.h"
+
+/************************************************
+ *  Macro definitions used by the statistics.
+ ***********************************************/
+#define STATS_SPEED_BIN_WIDTH		5	// Km/h
+#define STATS_THROTTLE_BIN_WIDTH	10	// Percent of throttle
+#define STATS_SPEED_BINS		(MAX_POSSIBLE_SPEED/STATS_SPEED_BIN_WIDTH + 1)
+#define STATS_THROTTLE_BINS		(MAX_THROTTLE_POSSIBLE/STATS_THROTTLE_BIN_WIDTH + 1)
+
+/** Torque is integral, so one histogram bin per Newton Meter gives exact quantiles */
+#define STATS_TORQUE_MIN		TORQUE_ERROR_VALUE
+#define STATS_TORQUE_MAX		TORQUE_AT_MAX_ANGLE
+#define STATS_TORQUE_BINS		(STATS_TORQUE_MAX - STATS_TORQUE_MIN + 1)
+
+/************************************************
+ *  Structure definitions
+ ***********************************************/
+typedef struct {
+	uint64_t count;
+	signed char min;
+	signed char max;
+	int64_t sum;
+	uint64_t histogram[STATS_TORQUE_BINS];	// Torque outside the range is clamped to the end bins
+}TorqueStatsCell_t;
+
+/************************************************
+ *  Function definitions
+ ***********************************************/
+
+/** @brief Clears all cells.
+ *  @param[in]
+ *  @param[ret]
+ *  @note
+ */
+void torque_stats_reset(void);
+
+/** @brief Adds a commanded torque to the cell of its speed and throttle bin.
+ *  @param[in]  speed.
+ *  @param[in]  angle.
+ *  @param[in]  torque.
+ *  @param[ret]
+ *  @note Constant time and allocation free. Speeds above MAX_POSSIBLE_SPEED are
+ * 	   counted in the last speed bin, invalid angles are only counted as rejected.
+ */
+void torque_stats_add(unsigned int speed, float angle, signed char torque);
+
+/** @brief Returns the cell of a speed and throttle bin.
+ *  @param[in]  speed_bin.
+ *  @param[in]  throttle_bin.
+ *  @param[ret] cell, NULL if a bin is out of range.
+ *  @note
+ */
+const TorqueStatsCell_t* torque_stats_get_cell(unsigned int speed_bin, unsigned int throttle_bin);
+
+/** @brief Returns the torque below which the given fraction of the samples of a cell lies.
+ *  @param[in]  cell.
+ *  @param[in]  quantile between 0 and 1.
+ *  @param[ret] torque
+ *  @note
+ */
+signed char torque_stats_quantile(const TorqueStatsCell_t *cell, float quantile);
+
+/** @brief Prints count, min, max, mean and quantiles of all non-empty cells.
+ *  @param[in]  out stream to print to.
+ *  @param[ret]
+ *  @note Meant to be called outside the torque stage. A dump taken while another
+ * 	   thread adds samples may be a sample behind in some cells.
+ */
+void torque_stats_dump(FILE *out);
+
+#endif /* TORQUE_STATISTICS_H_ */
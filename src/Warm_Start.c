@@ -0,0 +1,211 @@
+/** @file
+ *  @brief warm-start file.
+ *  @description This module checkpoints the moving average filter and the torque
+ *  		 tables, so the controller gives full quality output from the very
+ *  		 first cycle after a restart.
+ */
+
+#include "Warm_Start.h"
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+static int64_t s_last_save_s				=	0;
+
+/** The state is copied by the thread owning it and written by the saving thread */
+static pthread_mutex_t s_SnapshotMutex			=	PTHREAD_MUTEX_INITIALIZER;
+static TorqueModuleState_t s_snapshot			=	{0};
+static bool s_snapshot_fresh				=	false;
+static atomic_bool s_capture_requested			=	false;
+
+static uint32_t get_crc32(const void *data, size_t size)
+/**
+ * Description: Bitwise CRC-32 (IEEE), the payload is only a few kilobytes.
+ * Inputs: 	data
+ * 	: 	size
+ * Output:
+ * return: 	crc
+ */
+{
+	const uint8_t *lv_Data = (const uint8_t*)data;
+	uint32_t lv_Crc = 0xFFFFFFFFu;
+
+	for(size_t i = 0; i < size; i++) {
+		lv_Crc ^= lv_Data[i];
+		for(unsigned int bit = 0; bit < 8; bit++) {
+			lv_Crc = (lv_Crc >> 1) ^ (0xEDB88320u & (0u - (lv_Crc & 1)));
+		}
+	}
+	return ~lv_Crc;
+}
+
+static int64_t get_time_s(clockid_t clock)
+{
+	struct timespec lv_now;
+	clock_gettime(clock, &lv_now);
+	return lv_now.tv_sec;
+}
+
+int warm_start_load(const char *path, int64_t max_age_s)
+/**
+ * Description: Maps a checkpoint and restores it when it is valid and recent.
+ * Inputs: 	path
+ * 	: 	max_age_s
+ * Output:
+ * return: 	OK / NOK
+ */
+{
+	struct stat lv_stat;
+	int lvResult = NOK;
+	int lv_fd = open(path, O_RDONLY);
+
+	if(lv_fd < 0) {
+		printf("[WARM] No checkpoint %s, cold start\n", path);
+		return NOK;
+	}
+	if(fstat(lv_fd, &lv_stat) != 0 || lv_stat.st_size != sizeof(WarmStartFile_t)) {
+		printf("[WARM] Checkpoint %s has an unexpected size, cold start\n", path);
+		close(lv_fd);
+		return NOK;
+	}
+
+	const WarmStartFile_t *lv_File = mmap(NULL, sizeof(WarmStartFile_t), PROT_READ, MAP_PRIVATE, lv_fd, 0);
+	close(lv_fd);
+	if(lv_File == MAP_FAILED) {
+		printf("[WARM] Could not map %s, cold start\n", path);
+		return NOK;
+	}
+
+	int64_t lv_Age = get_time_s(CLOCK_REALTIME) - lv_File->saved_at_s;
+
+	if(lv_File->magic != WARM_START_MAGIC || lv_File->version != WARM_START_VERSION || \
+	   lv_File->payload_size != sizeof(TorqueModuleState_t)) {
+		printf("[WARM] Checkpoint %s is incompatible, cold start\n", path);
+	} else if(lv_File->crc != get_crc32(&lv_File->payload, sizeof(lv_File->payload))) {
+		printf("[WARM] Checkpoint %s is corrupt, cold start\n", path);
+	} else if(lv_Age < 0 || lv_Age > max_age_s) {
+		printf("[WARM] Checkpoint %s is %llds old, cold start\n", path, (long long)lv_Age);
+	} else if(torque_module_set_state(&lv_File->payload) != OK) {
+		printf("[WARM] Checkpoint %s is inconsistent, cold start\n", path);
+	} else {
+		printf("[WARM] Restored checkpoint %s (%llds old)\n", path, (long long)lv_Age);
+		lvResult = OK;
+	}
+
+	(void)munmap((void*)lv_File, sizeof(WarmStartFile_t));
+	s_last_save_s = get_time_s(CLOCK_MONOTONIC);
+	return lvResult;
+}
+
+void warm_start_capture(void)
+/**
+ * Description: Copies the current state into the snapshot.
+ * Inputs:
+ * Output:
+ * return:
+ */
+{
+	pthread_mutex_lock(&s_SnapshotMutex);
+	torque_module_get_state(&s_snapshot);
+	s_snapshot_fresh = true;
+	pthread_mutex_unlock(&s_SnapshotMutex);
+	atomic_store_explicit(&s_capture_requested, false, memory_order_relaxed);
+}
+
+void warm_start_capture_if_requested(void)
+/**
+ * Description: Copies the current state into the snapshot once warm_start_save_if_due()
+ * 		asked for it.
+ * Inputs:
+ * Output:
+ * return:
+ */
+{
+	if(atomic_load_explicit(&s_capture_requested, memory_order_relaxed)) {
+		warm_start_capture();
+	}
+}
+
+int warm_start_save(const char *path)
+/**
+ * Description: Writes the last snapshot to path.tmp and renames it over path.
+ * Inputs: 	path
+ * Output:
+ * return: 	OK / NOK
+ */
+{
+	static WarmStartFile_t s_file;
+	char lv_TmpPath[256];
+
+	if(snprintf(lv_TmpPath, sizeof(lv_TmpPath), "%s.tmp", path) >= (int)sizeof(lv_TmpPath)) {
+		return NOK;
+	}
+
+	pthread_mutex_lock(&s_SnapshotMutex);
+	bool lv_Captured = s_snapshot_fresh;
+	s_file.payload = s_snapshot;
+	s_snapshot_fresh = false;
+	pthread_mutex_unlock(&s_SnapshotMutex);
+
+	if(!lv_Captured) {
+		return NOK;
+	}
+
+	s_file.magic		=	WARM_START_MAGIC;
+	s_file.version		=	WARM_START_VERSION;
+	s_file.reserved	=	0;
+	s_file.payload_size	=	sizeof(TorqueModuleState_t);
+	s_file.saved_at_s	=	get_time_s(CLOCK_REALTIME);
+	s_file.crc		=	get_crc32(&s_file.payload, sizeof(s_file.payload));
+
+	int lv_fd = open(lv_TmpPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if(lv_fd < 0) {
+		return NOK;
+	}
+	/** No fsync, a checkpoint lost or torn by a power cut fails the size or
+	 *  CRC check on load and only costs a cold start.
+	 */
+	ssize_t lv_Written = write(lv_fd, &s_file, sizeof(s_file));
+	close(lv_fd);
+
+	if(lv_Written != (ssize_t)sizeof(s_file) || rename(lv_TmpPath, path) != 0) {
+		(void)unlink(lv_TmpPath);
+		return NOK;
+	}
+	s_last_save_s = get_time_s(CLOCK_MONOTONIC);
+	return OK;
+}
+
+void warm_start_save_if_due(const char *path)
+/**
+ * Description: Every WARM_START_PERIOD_S seconds requests a snapshot from the owning
+ * 		thread, and saves it once it has been captured.
+ * Inputs: 	path
+ * Output:
+ * return:
+ */
+{
+	if(get_time_s(CLOCK_MONOTONIC) - s_last_save_s < WARM_START_PERIOD_S || \
+	   atomic_load_explicit(&s_capture_requested, memory_order_relaxed)) {
+		return;
+	}
+
+	pthread_mutex_lock(&s_SnapshotMutex);
+	bool lv_Captured = s_snapshot_fresh;
+	pthread_mutex_unlock(&s_SnapshotMutex);
+
+	if(!lv_Captured) {
+		atomic_store_explicit(&s_capture_requested, true, memory_order_relaxed);
+	} else if(warm_start_save(path) != OK) {
+		printf("[WARM] Could not save checkpoint %s\n", path);
+		s_last_save_s = get_time_s(CLOCK_MONOTONIC);
+	}
+}
@@ -0,0 +1,79 @@
+/**
+ * @file
+ * @brief Header file for the warm-start checkpoint of filter and estimator state.
+ */
+
+#ifndef WARM_START_H_
+#define WARM_START_H_
+
+#include <stdint.h>
+#include "Torque_Module.h"
+
+/************************************************
+ *  Macro definitions used by the checkpoint.
+ ***********************************************/
+#define WARM_START_FILE		"warm_start.bin"
+#define WARM_START_MAGIC		0x5753544bu	// "WSTK"
+#define WARM_START_VERSION		1
+#define WARM_START_MAX_AGE_S		3600	// Older checkpoints are not loaded
+#define WARM_START_PERIOD_S		10	// Interval of periodic checkpoints
+
+/************************************************
+ *  Structure definitions
+ ***********************************************/
+typedef struct {
+	uint32_t magic;
+	uint16_t version;
+	uint16_t reserved;
+	uint32_t payload_size;		// sizeof(TorqueModuleState_t)
+	uint32_t crc;			// CRC-32 of the payload
+	int64_t saved_at_s;		// CLOCK_REALTIME seconds
+	TorqueModuleState_t payload;
+}WarmStartFile_t;
+
+/************************************************
+ *  Function definitions
+ ***********************************************/
+
+/** @brief Maps a checkpoint and restores it when it is valid and not older than max_age_s.
+ *  @param[in]  path of the checkpoint.
+ *  @param[in]  max_age_s maximum age in seconds.
+ *  @param[ret] OK if the state was restored, NOK otherwise (nothing is changed then).
+ *  @note
+ */
+int warm_start_load(const char *path, int64_t max_age_s);
+
+/** @brief Copies the current filter and table state into the snapshot that
+ * 	   warm_start_save() writes.
+ *  @param[in]
+ *  @param[ret]
+ *  @note Must be called from the thread that runs the angle calculation, or once
+ * 	   that thread has exited.
+ */
+void warm_start_capture(void);
+
+/** @brief Calls warm_start_capture() when warm_start_save_if_due() requested a snapshot.
+ *  @param[in]
+ *  @param[ret]
+ *  @note Same thread rule as warm_start_capture(). Costs an atomic load otherwise.
+ */
+void warm_start_capture_if_requested(void);
+
+/** @brief Writes the last snapshot to a checkpoint. The file is replaced atomically,
+ * 	   so a crash while saving keeps the previous checkpoint.
+ *  @param[in]  path of the checkpoint.
+ *  @param[ret] OK, NOK if nothing was captured since the last save or writing failed.
+ *  @note Only one thread may save.
+ */
+int warm_start_save(const char *path);
+
+/** @brief Requests a snapshot when WARM_START_PERIOD_S seconds have passed since the
+ * 	   last checkpoint, and saves it with warm_start_save() once it is captured.
+ *  @param[in]  path of the checkpoint.
+ *  @param[ret]
+ *  @note Meant for a thread outside the control loop; the file is never written by
+ * 	   the thread running the angle calculation in multi-threaded mode.
+ */
+void warm_start_save_if_due(const char *path);
+
+#endif /* WARM_START_H_ */
@@ -0,0 +1,214 @@
+/** @file
+ *  @brief watchdog file.
+ *  @description This module detects stalled calculator threads from their heartbeat
+ *  		 counters, raises a fault per stalled stage and keeps statistics on how
+ *  		 late each stage was.
+ */
+
+#include "Watchdog.h"
+
+#include "Fault_Recorder.h"
+#include "Realtime_Memory.h"
+#include "Torque_Module.h"
+#include "Torque_Snapshot.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <unistd.h>
+
+WatchdogHeartbeat_t g_WatchdogHeartbeats[_PipelineStages];
+
+static const uint64_t s_deadline_cycles[_PipelineStages]	=	{
+	WATCHDOG_ANGLE_DEADLINE_CYCLES,
+	WATCHDOG_SPEED_DEADLINE_CYCLES,
+	WATCHDOG_TORQUE_DEADLINE_CYCLES
+};
+static uint64_t s_deadline_ns[_PipelineStages];
+static const FaultCode s_stall_faults[_PipelineStages]	=	{FaultAngleStall, FaultSpeedStall, FaultTorqueStall};
+static const char *s_stage_names[_PipelineStages]	=	{"angle", "speed", "torque"};
+
+static WatchdogStageStats_t s_stage_stats[_PipelineStages]	=	{{0}};
+static uint64_t s_last_beat_ns[_PipelineStages]		=	{0};
+static pthread_mutex_t s_WatchdogMutex			=	PTHREAD_MUTEX_INITIALIZER;
+
+static pthread_t s_monitor_thread;
+static atomic_bool s_monitor_running				=	false;
+static uint64_t s_stopped_ns					=	0;
+
+static void Add_Gap(WatchdogStageStats_t *ioStats, uint64_t gap_ns, uint64_t deadline_ns)
+/**
+ * Description: Accounts a heartbeat gap in the lateness statistics of a stage.
+ * Inputs: 	gap_ns
+ * 	: 	deadline_ns
+ * Output: 	ioStats
+ * return:
+ */
+{
+	if(gap_ns > ioStats->max_gap_ns) {
+		ioStats->max_gap_ns = gap_ns;
+	}
+	if(gap_ns > deadline_ns) {
+		ioStats->deadline_misses++;
+		ioStats->total_late_ns += gap_ns - deadline_ns;
+		if(gap_ns - deadline_ns > ioStats->max_late_ns) {
+			ioStats->max_late_ns = gap_ns - deadline_ns;
+		}
+	}
+}
+
+static void Raise_Stall(PipelineStage stage)
+/**
+ * Description: Raises the stall fault of a stage, with the latest published tuple
+ * 		as freeze frame.
+ * Inputs: 	stage
+ * Output:
+ * return:
+ */
+{
+	TorqueSnapshot_t lv_Snapshot;
+	FaultFreezeFrame_t lv_Frame = {0};
+
+	(void)torque_snapshot_read(&lv_Snapshot);
+	lv_Frame.angle	=	lv_Snapshot.angle;
+	lv_Frame.speed	=	lv_Snapshot.speed;
+
+	printf("[WATCHDOG] %s stage missed its deadline\n", s_stage_names[stage]);
+	fault_recorder_raise(s_stall_faults[stage], &lv_Frame);
+}
+
+static void* Watchdog_Monitor_Thread(void *args)
+/**
+ * Description: Polls the heartbeats every WATCHDOG_POLL_MS. A stage whose counter has
+ * 		not changed for longer than its deadline is stalled; the fault is cleared
+ * 		and the gap accounted once it completes again.
+ * Inputs:
+ * Output:
+ * return:
+ */
+{
+	uint64_t lv_LastCount[_PipelineStages];
+	bool lv_Stalled[_PipelineStages] = {false};
+
+	(void)args;
+	if(rt_memory_enabled()) {
+		rt_memory_prefault_stack();
+	}
+	for(unsigned int i = 0; i < _PipelineStages; i++) {
+		lv_LastCount[i] = atomic_load_explicit(&g_WatchdogHeartbeats[i].count, memory_order_relaxed);
+	}
+
+	while(atomic_load(&s_monitor_running)) {
+		usleep(WATCHDOG_POLL_MS * 1000);
+		uint64_t lv_now = profiler_now_ns();
+
+		for(unsigned int i = 0; i < _PipelineStages; i++) {
+			uint64_t lv_Count = atomic_load_explicit(&g_WatchdogHeartbeats[i].count, memory_order_relaxed);
+
+			pthread_mutex_lock(&s_WatchdogMutex);
+			uint64_t lv_Gap = lv_now - s_last_beat_ns[i];
+
+			if(lv_Count != lv_LastCount[i]) {
+				Add_Gap(&s_stage_stats[i], lv_Gap, s_deadline_ns[i]);
+				s_last_beat_ns[i] = lv_now;
+			}
+			pthread_mutex_unlock(&s_WatchdogMutex);
+
+			if(lv_Count != lv_LastCount[i]) {
+				lv_LastCount[i] = lv_Count;
+				if(lv_Stalled[i]) {
+					lv_Stalled[i] = false;
+					fault_recorder_clear(s_stall_faults[i]);
+				}
+			} else if(!lv_Stalled[i] && lv_Gap > s_deadline_ns[i]) {
+				lv_Stalled[i] = true;
+				Raise_Stall((PipelineStage)i);
+			}
+		}
+	}
+	return NULL;
+}
+
+int watchdog_start(uint64_t cycle_period_ns)
+/**
+ * Description: Sets the deadline of every stage from the cycle period, takes the start
+ * 		as the first heartbeat of every stage and starts the monitor thread.
+ * Inputs: 	cycle_period_ns
+ * Output:
+ * return: 	OK / NOK
+ */
+{
+	pthread_attr_t lv_thread_attr;
+	int lvResult = OK;
+
+	if(atomic_exchange(&s_monitor_running, true)) {
+		return OK;
+	}
+
+	for(unsigned int i = 0; i < _PipelineStages; i++) {
+		s_deadline_ns[i] = s_deadline_cycles[i] * cycle_period_ns;
+		if(s_deadline_ns[i] < WATCHDOG_MIN_DEADLINE_MS * 1000000ull) {
+			s_deadline_ns[i] = WATCHDOG_MIN_DEADLINE_MS * 1000000ull;
+		}
+		s_last_beat_ns[i] = profiler_now_ns();
+	}
+
+	(void)pthread_attr_init(&lv_thread_attr);
+		(void)pthread_attr_setstacksize(&lv_thread_attr, RT_THREAD_STACK_SIZE);
+
+	if(pthread_create(&s_monitor_thread, &lv_thread_attr, Watchdog_Monitor_Thread, NULL) != 0) {
+		atomic_store(&s_monitor_running, false);
+		lvResult = NOK;
+	}
+	(void)pthread_attr_destroy(&lv_thread_attr);
+	return lvResult;
+}
+
+void watchdog_stop(void)
+/**
+ * Description: Stops and joins the monitor thread.
+ * Inputs:
+ * Output:
+ * return:
+ */
+{
+	if(atomic_exchange(&s_monitor_running, false)) {
+		(void)pthread_join(s_monitor_thread, NULL);
+		s_stopped_ns = profiler_now_ns();
+	}
+}
+
+void watchdog_get_stats(PipelineStage stage, WatchdogStageStats_t *outStats)
+/**
+ * Description: Copies the lateness statistics of a stage. Once the watchdog is stopped,
+ * 		a stall still open at that time is included as a miss.
+ * Inputs: 	stage
+ * Output: 	outStats
+ * return:
+ */
+{
+	pthread_mutex_lock(&s_WatchdogMutex);
+	*outStats = s_stage_stats[stage];
+	if(s_stopped_ns > s_last_beat_ns[stage]) {
+		Add_Gap(outStats, s_stopped_ns - s_last_beat_ns[stage], s_deadline_ns[stage]);
+	}
+	pthread_mutex_unlock(&s_WatchdogMutex);
+}
+
+void watchdog_report(FILE *out)
+/**
+ * Description: Prints the lateness statistics of all stages.
+ * Inputs: 	out
+ * Output:
+ * return:
+ */
+{
+	for(unsigned int i = 0; i < _PipelineStages; i++) {
+		WatchdogStageStats_t lv_Stats;
+
+		watchdog_get_stats((PipelineStage)i, &lv_Stats);
+		fprintf(out, "Watchdog %-7s misses:%llu max_gap:%.1f ms max_late:%.1f ms avg_late:%.1f ms\n",
+				s_stage_names[i], (unsigned long long)lv_Stats.deadline_misses, lv_Stats.max_gap_ns / 1e6,
+				lv_Stats.max_late_ns / 1e6,
+				lv_Stats.deadline_misses ? lv_Stats.total_late_ns / 1e6 / lv_Stats.deadline_misses : 0.0);
+	}
+}
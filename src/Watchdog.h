@@ -0,0 +1,93 @@
+/**
+ * @file
+ * @brief Header file for the thread heartbeat watchdog.
+ */
+
+#ifndef WATCHDOG_H_
+#define WATCHDOG_H_
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "Pipeline_Profiler.h"
+
+/************************************************
+ *  Macro definitions used by the watchdog.
+ ***********************************************/
+#define WATCHDOG_CACHE_LINE_SIZE	64
+#define WATCHDOG_POLL_MS		100	// Monitor period, also the resolution of the lateness
+#define WATCHDOG_ANGLE_DEADLINE_CYCLES	3	// Deadlines in cycle periods, a stage completes
+#define WATCHDOG_SPEED_DEADLINE_CYCLES	3	// once per cycle and retries a failure after
+#define WATCHDOG_TORQUE_DEADLINE_CYCLES	3	// one more period
+#define WATCHDOG_MIN_DEADLINE_MS	2500	// Lower bound of every deadline, e.g. with --no-sleep
+
+/************************************************
+ *  Structure definitions
+ ***********************************************/
+/** One heartbeat per cache line, so stages never share a line */
+typedef struct {
+	_Alignas(WATCHDOG_CACHE_LINE_SIZE) atomic_uint_fast64_t count;
+}WatchdogHeartbeat_t;
+
+typedef struct {
+	uint64_t deadline_misses;	// Heartbeat gaps longer than the deadline
+	uint64_t max_gap_ns;		// Longest heartbeat gap seen
+	uint64_t max_late_ns;		// Longest gap minus deadline
+	uint64_t total_late_ns;	// Sum of all gaps minus deadline
+}WatchdogStageStats_t;
+
+/************************************************
+ *  Global variable declarations
+ ***********************************************/
+extern WatchdogHeartbeat_t g_WatchdogHeartbeats[_PipelineStages];
+
+/************************************************
+ *  Function definitions
+ ***********************************************/
+
+/** @brief Signals that a stage completed. Only the thread running the stage may call it.
+ *  @param[in]  stage.
+ *  @param[ret]
+ *  @note A relaxed load and a single relaxed store on the stage's own cache line.
+ * 	   Called after each completed stage, not while waiting, so a thread that is
+ * 	   alive but makes no progress misses its deadline.
+ */
+static inline void watchdog_heartbeat(PipelineStage stage)
+{
+	atomic_uint_fast64_t *lv_Count = &g_WatchdogHeartbeats[stage].count;
+
+	atomic_store_explicit(lv_Count, atomic_load_explicit(lv_Count, memory_order_relaxed) + 1, memory_order_relaxed);
+}
+
+/** @brief Starts the monitor thread, which checks every WATCHDOG_POLL_MS that each
+ * 	   stage has beaten within its deadline and raises a stall fault otherwise.
+ *  @param[in]  cycle_period_ns expected time between two completions of a stage.
+ *  @param[ret] OK / NOK if the thread could not be created.
+ *  @note The deadline of each stage is its WATCHDOG_*_DEADLINE_CYCLES cycle periods,
+ * 	   at least WATCHDOG_MIN_DEADLINE_MS.
+ */
+int watchdog_start(uint64_t cycle_period_ns);
+
+/** @brief Stops and joins the monitor thread.
+ *  @param[in]
+ *  @param[ret]
+ *  @note
+ */
+void watchdog_stop(void);
+
+/** @brief Copies the lateness statistics of a stage.
+ *  @param[in]  stage.
+ *  @param[out] outStats
+ *  @param[ret]
+ *  @note After watchdog_stop() a stall that was still open is included as a miss.
+ */
+void watchdog_get_stats(PipelineStage stage, WatchdogStageStats_t *outStats);
+
+/** @brief Prints the lateness statistics of all stages.
+ *  @param[in]  out stream to print to.
+ *  @param[ret]
+ *  @note
+ */
+void watchdog_report(FILE *out);
+
+#endif /* WATCHDOG_H_ */
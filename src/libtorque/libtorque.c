@@ -0,0 +1,87 @@
+/** @file
+ *  @brief Source file for the libtorque shared library C ABI.
+ *
+ *  Thin wrappers around the production torque, speed and ADC functions, so the
+ *  pedal map can be evaluated over large datasets outside the controller.
+ */
+
+#include "libtorque.h"
+
+#include "Torque_Module.h"
+
+static int is_in_map(float angle, uint32_t speed) {
+  return angle >= MIN_ANGLE && angle <= MAX_ANGLE && speed <= MAX_POSSIBLE_SPEED;
+}
+
+uint32_t libtorque_abi_version(void) {
+  return LIBTORQUE_ABI_VERSION;
+}
+
+int32_t libtorque_init(void) {
+  init_two_speed_torque_data();
+  return OK;
+}
+
+int8_t libtorque_torque(float angle, uint32_t speed, int32_t two_speed) {
+  if (!is_in_map(angle, speed)) {
+    return TORQUE_ERROR_VALUE;
+  }
+  return two_speed ? get_torque_two_speed(angle, speed == SPEED_AT_REST ? Resting : Moving)
+                   : get_torque_rpm_based_speed(angle, speed);
+}
+
+int64_t libtorque_torque_batch(const float *angles, const uint32_t *speeds,
+                               int8_t *torques, size_t count, int32_t two_speed) {
+  int64_t rejected = 0;
+
+  if (angles == NULL || speeds == NULL || torques == NULL) {
+    return NOK;
+  }
+  for (size_t i = 0; i < count; i++) {
+    if (!is_in_map(angles[i], speeds[i])) {
+      rejected++;
+    }
+    torques[i] = libtorque_torque(angles[i], speeds[i], two_speed);
+  }
+  return rejected;
+}
+
+int64_t libtorque_speed_batch(const uint32_t *timer_counts, uint32_t *speeds,
+                              size_t count) {
+  int64_t rejected = 0;
+
+  if (timer_counts == NULL || speeds == NULL) {
+    return NOK;
+  }
+  for (size_t i = 0; i < count; i++) {
+    if (timer_counts[i] == 0) {
+      speeds[i] = SPEED_ERR_THRESHOLD;
+      rejected++;
+    } else {
+      speeds[i] = get_rpm_based_speed(timer_counts[i]);
+    }
+  }
+  return rejected;
+}
+
+int64_t libtorque_adc_batch(uint32_t channel, const float *angles,
+                            uint16_t *adc_values, size_t count) {
+  if (channel >= ADC_NUM_CHANNELS || angles == NULL || adc_values == NULL) {
+    return NOK;
+  }
+  for (size_t i = 0; i < count; i++) {
+    adc_values[i] = calc_raw_adc_value((adc_channel_id_t)channel, angles[i]);
+  }
+  return OK;
+}
+
+int64_t libtorque_filter_batch(uint32_t channel, const float *angles,
+                               uint16_t *adc_values, size_t count) {
+  if (channel >= ADC_NUM_CHANNELS || angles == NULL || adc_values == NULL) {
+    return NOK;
+  }
+  for (size_t i = 0; i < count; i++) {
+    adc_values[i] = calc_adc_value((adc_channel_id_t)channel, angles[i]);
+  }
+  return OK;
+}
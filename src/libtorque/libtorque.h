@@ -0,0 +1,98 @@
+/** @file
+ *  @brief Header file for the libtorque shared library C ABI.
+ *
+ *  All entry points use fixed width types and plain pointers, so they can be
+ *  called from any language with a C FFI (e.g. Python ctypes). Batch entry points
+ *  work in place on caller owned contiguous buffers without copying.
+ */
+#ifndef LIBTORQUE_LIBTORQUE_H_
+#define LIBTORQUE_LIBTORQUE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(__GNUC__)
+#define LIBTORQUE_API	__attribute__((visibility("default")))
+#else
+#define LIBTORQUE_API
+#endif
+
+/** @brief Bumped whenever an entry point changes in an incompatible way. */
+#define LIBTORQUE_ABI_VERSION	1
+
+/** @brief Returns the ABI version the library was built with.
+ *  @returns LIBTORQUE_ABI_VERSION.
+ */
+LIBTORQUE_API uint32_t libtorque_abi_version(void);
+
+/** @brief Initializes the torque tables. Must be called once before any torque
+ *    entry point.
+ *  @returns 0 on success.
+ *  @note Prints nothing, the host keeps its stdout.
+ */
+LIBTORQUE_API int32_t libtorque_init(void);
+
+/** @brief Returns torque for a single angle and speed.
+ *  @param[in] angle Pedal angle in degrees [0, 30].
+ *  @param[in] speed Speed in km/h [0, 50].
+ *  @param[in] two_speed Non-zero selects the two speed map (0 km/h = resting,
+ *    anything else = moving), zero the speed based map.
+ *  @returns Torque in Newton Meter, -50 for inputs outside the map.
+ */
+LIBTORQUE_API int8_t libtorque_torque(float angle, uint32_t speed, int32_t two_speed);
+
+/** @brief Computes torque for count (angle, speed) pairs.
+ *  @param[in] angles count pedal angles in degrees.
+ *  @param[in] speeds count speeds in km/h.
+ *  @param[out] torques count torques in Newton Meter, may not alias the inputs.
+ *  @param[in] count Number of samples.
+ *  @param[in] two_speed See libtorque_torque().
+ *  @returns Number of samples outside the map (set to -50), or -1 on a NULL buffer.
+ *  @note Thread safe after libtorque_init().
+ */
+LIBTORQUE_API int64_t libtorque_torque_batch(const float *angles, const uint32_t *speeds,
+                                             int8_t *torques, size_t count, int32_t two_speed);
+
+/** @brief Computes speed for count rotation timer counts.
+ *  @param[in] timer_counts count milliseconds between two rotations.
+ *  @param[out] speeds count speeds in km/h.
+ *  @param[in] count Number of samples.
+ *  @returns Number of zero timer counts (speed set to 51), or -1 on a NULL buffer.
+ *  @note Thread safe.
+ */
+LIBTORQUE_API int64_t libtorque_speed_batch(const uint32_t *timer_counts, uint32_t *speeds,
+                                            size_t count);
+
+/** @brief Converts count angles to unfiltered ADC values of a channel.
+ *  @param[in] channel 0 for adc1, 1 for adc2.
+ *  @param[in] angles count pedal angles in degrees.
+ *  @param[out] adc_values count ADC values.
+ *  @param[in] count Number of samples.
+ *  @returns 0, or -1 on an invalid channel or a NULL buffer.
+ *  @note Thread safe.
+ */
+LIBTORQUE_API int64_t libtorque_adc_batch(uint32_t channel, const float *angles,
+                                          uint16_t *adc_values, size_t count);
+
+/** @brief Streams count angles through the ADC conversion and the moving average
+ *    filter of a channel, in order.
+ *  @param[in] channel 0 for adc1, 1 for adc2.
+ *  @param[in] angles count pedal angles in degrees.
+ *  @param[out] adc_values count filtered ADC values.
+ *  @param[in] count Number of samples.
+ *  @returns 0, or -1 on an invalid channel or a NULL buffer.
+ *  @note Each channel has its own filter state, which is process wide and kept
+ *    between calls exactly like in the controller; calls must not run concurrently.
+ */
+LIBTORQUE_API int64_t libtorque_filter_batch(uint32_t channel, const float *angles,
+                                             uint16_t *adc_values, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // LIBTORQUE_LIBTORQUE_H_
@@ -6,26 +6,155 @@
 #include <stdio.h>
 #include "drivers/error_led/error_led.h"
 #include <unistd.h>
+#include <stdlib.h>
+#include <limits.h>
 #include <string.h>
 #include <pthread.h>
+#include <sched.h>
+#include <signal.h>
 #include "Torque_Module.h"
+#include "Torque_Cache.h"
+#include "Accuracy_Harness.h"
+#include "Fault_Recorder.h"
+#include "Torque_Snapshot.h"
+#include "Torque_Statistics.h"
+#include "Realtime_Memory.h"
+#include "Torque_Split.h"
+#include "Pipeline_Profiler.h"
+#include "Warm_Start.h"
+#include "Watchdog.h"
 
 /************************************************
  * 	Module definitions
  ***********************************************/
 static bool 	g_TwoSpeed	=	true, \
-	g_ThreadedImplementation = false;
+	g_ThreadedImplementation = false, \
+	g_RealtimeMemory = false, \
+	g_NoSleep = false, \
+	g_Quiet = false, \
+	g_WarmStart = false;
+
+static uint64_t	g_Cycles	=	0;	// 0 - run forever
 
 static float 	s_Angle = 0.0;
 static signed char	s_Torque = 0;
 
 static unsigned int s_Speed = 0;
 
+static const float	*s_MotorCommands = NULL;
+
+static adc_value_t	s_AdcValues[ADC_NUM_CHANNELS] = {0};
+
 static volatile bool 	s_AngleReleaseTorqueThread = false,  \
-			s_SpeedReleaseTorqueThread = false;
+			s_SpeedReleaseTorqueThread = false, \
+			s_PipelineDone = false;
 
 static pthread_mutex_t s_SharedMutex = PTHREAD_MUTEX_INITIALIZER;
 
+static volatile sig_atomic_t s_DumpStatsRequested = 0;
+
+static void Request_Stats_Dump(int signum)
+/**
+ * Description: SIGUSR1 handler, the statistics are dumped by the main thread
+ * 				between cycles so the handler stays async-signal-safe.
+ * Inputs:	signum
+ * Output:
+ * Return:
+ */
+{
+	(void)signum;
+	s_DumpStatsRequested = 1;
+}
+
+static void Dump_Stats_If_Requested(void)
+/**
+ * Description: The function prints the torque statistics after a SIGUSR1,
+ * 				outside of the torque stage and of the measured cycle.
+ * Inputs:
+ * Output:
+ * Return:
+ */
+{
+	if(s_DumpStatsRequested) {
+		s_DumpStatsRequested = 0;
+		torque_stats_dump(stdout);
+	}
+}
+
+static void Request_Shutdown(int signum)
+/**
+ * Description: SIGINT/SIGTERM handler, stops the calculator loops so that main
+ * 				can report and save its checkpoint before exiting.
+ * Inputs:	signum
+ * Output:
+ * Return:
+ */
+{
+	(void)signum;
+	s_PipelineDone = true;
+}
+
+static void Pipeline_Wait(useconds_t inMicroseconds)
+/**
+ * Description: The function throttles the calculator loops, unless --no-sleep
+ * 				is given, in which case it only yields the CPU.
+ * Inputs:	inMicroseconds
+ * Output:
+ * Return:
+ */
+{
+	if(g_NoSleep) {
+		(void)sched_yield();
+	} else {
+		(void)usleep(inMicroseconds);
+	}
+}
+
+static uint64_t Stage_Start(void)
+/**
+ * Description: The function returns the start time of a stage, only when the
+ * 				pipeline is profiled (--cycles N).
+ * Inputs:
+ * Output:
+ * Return:	nanoseconds
+ */
+{
+	return g_Cycles ? profiler_now_ns() : 0;
+}
+
+static void Stage_End(PipelineStage inStage, uint64_t inStart)
+/**
+ * Description: The function adds the time spent in a stage to the profiler.
+ * Inputs:	inStage
+ * 		:	inStart from Stage_Start()
+ * Output:
+ * Return:
+ */
+{
+	if(g_Cycles) {
+		profiler_add_stage(inStage, profiler_now_ns() - inStart);
+	}
+}
+
+static void Record_Fault(FaultCode inCode)
+/**
+ * Description: The function records a fault together with a freeze frame
+ * 				of the current angle, speed and ADC values.
+ * Inputs:	inCode
+ * Output:
+ * Return:
+ */
+{
+	FaultFreezeFrame_t lvFrame = {0};
+
+	lvFrame.angle	=	s_Angle;
+	lvFrame.speed	=	s_Speed;
+	lvFrame.adc[ADC_CHANNEL0]	=	s_AdcValues[ADC_CHANNEL0];
+	lvFrame.adc[ADC_CHANNEL1]	=	s_AdcValues[ADC_CHANNEL1];
+
+	fault_recorder_raise(inCode, &lvFrame);
+}
+
 static int Calculate_Angle(void)
 /**
  * Description: The function is created to elude code duplication
@@ -40,19 +169,24 @@ static int Calculate_Angle(void)
 		printf("throttle:%d %s\n", lvThrottleInput, lvThrottleInput==NOK?"should throw error":"OK");
 	#endif
 	if(lvThrottleInput == NOK) {
-		error_led_set(true);
+		s_AdcValues[ADC_CHANNEL0] = s_AdcValues[ADC_CHANNEL1] = ADC_ERROR_VALUE;
 		adc_read_set_output(ADC_CHANNEL0, ADC_ERROR_VALUE, ADC_RET_NOK);
 		adc_read_set_output(ADC_CHANNEL1, ADC_ERROR_VALUE, ADC_RET_NOK);
 		s_Angle = ANGLE_ERR_VALUE;
-		printf("[Error Angle Calc] Throttle_Percent < %d ; Assigned_Dummy_Angle:%.2fDeg\n", THROTTLE_ERR_THRESHOLD, s_Angle);
+		Record_Fault(FaultThrottleRange);
+		if(!g_Quiet)
+			printf("[Error Angle Calc] Throttle_Percent < %d ; Assigned_Dummy_Angle:%.2fDeg\n", THROTTLE_ERR_THRESHOLD, s_Angle);
 		return NOK;
 	} else {
 		s_Angle = get_pedal_angle(lvThrottleInput);
 		#if DEBUG
 			printf("s_Angle:%f\n", s_Angle);
 		#endif
-		adc_read_set_output(ADC_CHANNEL0, calc_adc_value(ADC_CHANNEL0, s_Angle), ADC_RET_OK);
-		adc_read_set_output(ADC_CHANNEL1, calc_adc_value(ADC_CHANNEL1, s_Angle), ADC_RET_OK);
+		s_AdcValues[ADC_CHANNEL0] = calc_adc_value(ADC_CHANNEL0, s_Angle);
+		s_AdcValues[ADC_CHANNEL1] = calc_adc_value(ADC_CHANNEL1, s_Angle);
+		adc_read_set_output(ADC_CHANNEL0, s_AdcValues[ADC_CHANNEL0], ADC_RET_OK);
+		adc_read_set_output(ADC_CHANNEL1, s_AdcValues[ADC_CHANNEL1], ADC_RET_OK);
+		fault_recorder_clear(FaultThrottleRange);
 	}
 	return OK;
 }
@@ -72,19 +206,38 @@ void* AngleCalc_Thread(void *args)
 	if(!g_ThreadedImplementation) {
 		lvResult	=	Calculate_Angle();
 	} else {
+		uint64_t lvCycle = 0;
+		RtCycleProbe_t lvProbe;
+
 		printf("Entering thread:%s ID:%lu\n", __func__, tid);
-		while(1) {
+		if(g_RealtimeMemory) {
+			rt_memory_prefault_stack();
+		}
+		while(!s_PipelineDone) {
 			if(!s_AngleReleaseTorqueThread) {
+				if(g_RealtimeMemory) {
+					rt_memory_begin_cycle(&lvProbe);
+				}
+				uint64_t lvStart = Stage_Start();
 				lvResult = Calculate_Angle();
+				Stage_End(StageAngle, lvStart);
+				if(g_RealtimeMemory) {
+					(void)rt_memory_end_cycle(&lvProbe, "Angle", lvCycle++);
+				}
+				/** The filter state is owned by this thread, the main thread writes the file */
+				if(g_WarmStart) {
+					warm_start_capture_if_requested();
+				}
 				if(lvResult == OK) {
+					watchdog_heartbeat(StageAngle);
 					pthread_mutex_lock(&s_SharedMutex);
 					s_AngleReleaseTorqueThread	=	true;
 					pthread_mutex_unlock(&s_SharedMutex);
 				} else {
-					sleep(1);
+					Pipeline_Wait(1000000);
 				}
 			}
-			usleep(1000);
+			Pipeline_Wait(1000);
 		}
 	}
 
@@ -109,10 +262,12 @@ static int Calculate_Speed(void)
 		printf("s_Speed:%u %s\n", s_Speed, s_Speed==SPEED_ERR_THRESHOLD ?"should throw error":"OK");
 	#endif
 	if(s_Speed > MAX_POSSIBLE_SPEED) {
-		error_led_set(true);
-		printf("[Error Speed Calc] Speed:%u\n", s_Speed);
+		Record_Fault(FaultSpeedRange);
+		if(!g_Quiet)
+			printf("[Error Speed Calc] Speed:%u\n", s_Speed);
 		return NOK;
 	}
+	fault_recorder_clear(FaultSpeedRange);
 	return OK;
 }
 
@@ -131,20 +286,34 @@ void* SpeedCalc_Thread(void *args)
 	if(!g_ThreadedImplementation) {
 		lvResult = Calculate_Speed();
 	} else {
+		uint64_t lvCycle = 0;
+		RtCycleProbe_t lvProbe;
+
 		printf("Entering thread:%s ID:%lu\n", __func__, tid);
-		while(1) {
+		if(g_RealtimeMemory) {
+			rt_memory_prefault_stack();
+		}
+		while(!s_PipelineDone) {
 			if(!s_SpeedReleaseTorqueThread) {
+				if(g_RealtimeMemory) {
+					rt_memory_begin_cycle(&lvProbe);
+				}
+				uint64_t lvStart = Stage_Start();
 				lvResult = Calculate_Speed();
+				Stage_End(StageSpeed, lvStart);
+				if(g_RealtimeMemory) {
+					(void)rt_memory_end_cycle(&lvProbe, "Speed", lvCycle++);
+				}
 				if(lvResult == OK) {
+					watchdog_heartbeat(StageSpeed);
 					pthread_mutex_lock(&s_SharedMutex);
 					s_SpeedReleaseTorqueThread	=	true;
 					pthread_mutex_unlock(&s_SharedMutex);
 				} else {
-					error_led_set(true);
-					sleep(1);
+					Pipeline_Wait(1000000);
 				}
 			}
-			usleep(1000);
+			Pipeline_Wait(1000);
 		}
 	}
 
@@ -160,16 +329,32 @@ static void Calculate_Torque(void)
  * Return:
  */
 {
-	if(g_TwoSpeed) {
-		s_Torque = get_torque_two_speed(s_Angle, s_Speed==0?Resting:Moving);
-		#if DEBUG
-			printf("TwoSpeed Torque:%d %s\n", s_Torque, s_Torque==(-50)?"should throw error":"OK");
-		#endif
-	} else {
-		s_Torque = get_torque_rpm_based_speed(s_Angle, s_Speed);
-		#if DEBUG
-			printf("Random Torque:%d %s\n", s_Torque, s_Torque==(-50)?"should throw error":"OK");
-		#endif
+	/** Both torque functions only depend on the throttle percent and speed,
+	 *  so the cached stage returns the same torque as calling them directly.
+	 */
+	s_Torque = get_torque_cached(s_Angle, s_Speed, g_TwoSpeed);
+	s_MotorCommands = torque_split_compute(s_Torque);
+	torque_snapshot_publish(s_Speed, s_Angle, s_Torque);
+	torque_stats_add(s_Speed, s_Angle, s_Torque);
+	#if DEBUG
+		printf("%s Torque:%d %s\n", g_TwoSpeed?"TwoSpeed":"Random", s_Torque, s_Torque==(-50)?"should throw error":"OK");
+	#endif
+}
+
+static void Print_Motor_Commands(void)
+/**
+ * Description: The function prints the per motor torque commands of the last
+ * 				torque calculation when more than one motor is configured.
+ * Inputs:
+ * Output:
+ * Return:
+ */
+{
+	if(torque_split_motor_count() > 1 && s_MotorCommands) {
+		for(unsigned int lvMotor = 0; lvMotor < torque_split_motor_count(); lvMotor++) {
+			printf("Motor%u:%.2fNm%s", lvMotor, s_MotorCommands[lvMotor],
+					lvMotor + 1 < torque_split_motor_count() ? " " : "\n");
+		}
 	}
 }
 
@@ -187,18 +372,40 @@ void* TorqueCalc_Thread(void *args)
 	if(!g_ThreadedImplementation) {
 		Calculate_Torque();
 	} else {
+		uint64_t lvCycle = 0;
+		RtCycleProbe_t lvProbe;
+
 		printf("Entering thread:%s ID:%lu\n", __func__, tid);
-		while(1)
+		if(g_RealtimeMemory) {
+			rt_memory_prefault_stack();
+		}
+		/** A cycle lasts from releasing the angle and speed threads until the
+		 *  next torque is calculated.
+		 */
+		uint64_t lvCycleStart = Stage_Start();
+		while(!s_PipelineDone)
 		{
 			if(s_AngleReleaseTorqueThread && s_SpeedReleaseTorqueThread) {
+				if(g_RealtimeMemory) {
+					rt_memory_begin_cycle(&lvProbe);
+				}
+				uint64_t lvStart = Stage_Start();
 				Calculate_Torque();
+				Stage_End(StageTorque, lvStart);
+				if(g_RealtimeMemory) {
+					(void)rt_memory_end_cycle(&lvProbe, "Torque", lvCycle);
+				}
+				watchdog_heartbeat(StageTorque);
 
-				adc_value_t lvADC1 = 0.0,  lvADC2 = 0.0;
-	    		(void)adc_read(ADC_CHANNEL0, &lvADC1);
-	    		(void)adc_read(ADC_CHANNEL1, &lvADC2);
+				if(!g_Quiet) {
+					adc_value_t lvADC1 = 0.0,  lvADC2 = 0.0;
+					(void)adc_read(ADC_CHANNEL0, &lvADC1);
+					(void)adc_read(ADC_CHANNEL1, &lvADC2);
 
-	    		printf("Speed:%uKm/h Throttle Angle:%.2fDeg Torque:%dNm ADC1:%u ADC2:%u\n",
-	    				s_Speed, s_Angle, s_Torque, lvADC1, lvADC2);
+					printf("Speed:%uKm/h Throttle Angle:%.2fDeg Torque:%dNm ADC1:%u ADC2:%u\n",
+							s_Speed, s_Angle, s_Torque, lvADC1, lvADC2);
+					Print_Motor_Commands();
+				}
 
 	    		s_Speed	=	s_Angle	=	s_Torque	=	0.0;
 
@@ -206,8 +413,16 @@ void* TorqueCalc_Thread(void *args)
 				s_AngleReleaseTorqueThread	=	false;
 				s_SpeedReleaseTorqueThread	=	false;
 				pthread_mutex_unlock(&s_SharedMutex);
+
+				lvCycle++;
+				if(g_Cycles) {
+					uint64_t lvNow = profiler_now_ns();
+					profiler_add_cycle(lvNow - lvCycleStart, false);
+					lvCycleStart = lvNow;
+					s_PipelineDone = (lvCycle >= g_Cycles);
+				}
 			}
-			usleep(1000000);
+			Pipeline_Wait(1000000);
 		}
 	}
 	return NULL;
@@ -215,7 +430,8 @@ void* TorqueCalc_Thread(void *args)
 
 void Thread_creator(void)
 /**
- * Description: The function creates Angle, Speed and Torque calculator threads.
+ * Description: The function creates Angle, Speed and Torque calculator threads,
+ * 				and the watchdog monitoring them.
  * 				these threads are just for DEMO, and is one of the ways of doing things.
  * 				A simpler implementation can simply call these three functions in sequence.
  * Inputs:
@@ -227,13 +443,21 @@ void Thread_creator(void)
 	pthread_attr_t lv_thread_attr1, lv_thread_attr2, lv_thread_attr3;
 
 	(void)pthread_attr_init(&lv_thread_attr1);
-		(void)pthread_attr_setdetachstate(&lv_thread_attr1, PTHREAD_CREATE_DETACHED);
+		(void)pthread_attr_setdetachstate(&lv_thread_attr1, PTHREAD_CREATE_JOINABLE);
+		(void)pthread_attr_setstacksize(&lv_thread_attr1, RT_THREAD_STACK_SIZE);
 
 	(void)pthread_attr_init(&lv_thread_attr2);
-		(void)pthread_attr_setdetachstate(&lv_thread_attr2, PTHREAD_CREATE_DETACHED);
+		(void)pthread_attr_setdetachstate(&lv_thread_attr2, PTHREAD_CREATE_JOINABLE);
+		(void)pthread_attr_setstacksize(&lv_thread_attr2, RT_THREAD_STACK_SIZE);
 
 	(void)pthread_attr_init(&lv_thread_attr3);
-		(void)pthread_attr_setdetachstate(&lv_thread_attr3, PTHREAD_CREATE_DETACHED);
+		(void)pthread_attr_setdetachstate(&lv_thread_attr3, PTHREAD_CREATE_JOINABLE);
+		(void)pthread_attr_setstacksize(&lv_thread_attr3, RT_THREAD_STACK_SIZE);
+
+	/* Spawn Watchdog Monitor Thread, the torque thread completes a cycle per 1s wait */
+	if(watchdog_start(g_NoSleep ? 0 : 1000000000ull) != OK) {
+		printf("Could not start the watchdog\n");
+	}
 
 	/* Spawn Angle Calculator Thread */
 	(void)pthread_create(&lv_angle_thread, &lv_thread_attr1, AngleCalc_Thread, NULL);
@@ -242,7 +466,20 @@ void Thread_creator(void)
 	/* Spawn Torque Calculator Thread */
 	(void)pthread_create(&lv_torque_thread, &lv_thread_attr3, TorqueCalc_Thread, NULL);
 
-	while(1);
+	/** Only returns once --cycles N cycles are done and the threads have exited */
+	while(!s_PipelineDone) {
+		Dump_Stats_If_Requested();
+		if(g_WarmStart) {
+			warm_start_save_if_due(WARM_START_FILE);
+		}
+		usleep(1000);
+	}
+	watchdog_stop();
+
+	/** The final checkpoint needs the angle thread to be out of the filter */
+	(void)pthread_join(lv_angle_thread, NULL);
+	(void)pthread_join(lv_speed_thread, NULL);
+	(void)pthread_join(lv_torque_thread, NULL);
 }
 
 int Torque_Calculator(void)
@@ -255,20 +492,40 @@ int Torque_Calculator(void)
  * Return:
  */
 {
+	uint64_t lvCycle = 0;
+	RtCycleProbe_t lvProbe;
+
 	printf("Entering thread:%s\n", __func__);
-    while(1)
+    while(!s_PipelineDone && ((g_Cycles == 0) || (lvCycle < g_Cycles)))
     {
+    	if(g_RealtimeMemory) {
+    		rt_memory_begin_cycle(&lvProbe);
+    	}
+    	uint64_t lvCycleStart = Stage_Start();
+
+    	uint64_t lvStart = Stage_Start();
     	int *lvResult = (int*)AngleCalc_Thread(NULL);
+    	Stage_End(StageAngle, lvStart);
 
     	if(*lvResult != NOK) {
+    		lvStart = Stage_Start();
     		lvResult = (int*)SpeedCalc_Thread(NULL);
+    		Stage_End(StageSpeed, lvStart);
     	}
 
     	if(*lvResult != NOK) {
+    		lvStart = Stage_Start();
     		(void)TorqueCalc_Thread(NULL);
+    		Stage_End(StageTorque, lvStart);
+    	}
+
+    	if(g_Cycles) {
+    		profiler_add_cycle(profiler_now_ns() - lvCycleStart, *lvResult == NOK);
     	}
 
-    	if(*lvResult == NOK) {
+    	if(g_Quiet) {
+    		/* Nothing to print in headless mode */
+    	} else if(*lvResult == NOK) {
     		printf("[Error Torque Calc]...\n");
     	} else {
     		adc_value_t lvADC1 = 0.0,  lvADC2 = 0.0;
@@ -277,8 +534,20 @@ int Torque_Calculator(void)
 
     		printf("Speed:%uKm/h Throttle Angle:%.2fDeg Torque:%dNm ADC1:%u ADC2:%u\n",
     				s_Speed, s_Angle, s_Torque, lvADC1, lvADC2);
+    		Print_Motor_Commands();
+    	}
+    	if(g_RealtimeMemory) {
+    		(void)rt_memory_end_cycle(&lvProbe, "Pipeline", lvCycle);
+    	}
+    	Dump_Stats_If_Requested();
+    	if(g_WarmStart) {
+    		warm_start_capture_if_requested();
+    		warm_start_save_if_due(WARM_START_FILE);
+    	}
+    	lvCycle++;
+    	if(!g_NoSleep) {
+    		sleep(1);
     	}
-    	sleep(1);
     }
 	return 0;
 }
@@ -296,13 +565,12 @@ int main(int argc, char *argv[])
   adc_init(ADC_CHANNEL0);
   adc_init(ADC_CHANNEL1);
 
-  if(argc == 3)
+  if(argc >= 3)
   {
 
 	if(strcmp(argv[1], "ts") == 0)
 	{
 		g_TwoSpeed = true;
-		init_two_speed_torque_data();
 		printf("Getting torque for distinct speed values\n");
 	}
 	else if(strcmp(argv[1], "cs") == 0)
@@ -333,20 +601,132 @@ int main(int argc, char *argv[])
 		error_led_set(true);
 		return -1;
 	}
+
+	for(int lvArg = 3; lvArg < argc; lvArg++)
+	{
+		if(strcmp(argv[lvArg], "--rt") == 0)
+		{
+			g_RealtimeMemory = true;
+			printf("Using real-time memory mode\n");
+		}
+		else if((strcmp(argv[lvArg], "--cycles") == 0) && (lvArg + 1 < argc))
+		{
+			char *lvEnd = NULL;
+			const char *lvValue = argv[++lvArg];
+
+			/** strtoull() accepts a sign and returns 0 for text, which would mean run forever */
+			g_Cycles = (lvValue[0] >= '0' && lvValue[0] <= '9') ? strtoull(lvValue, &lvEnd, 10) : 0;
+			if((g_Cycles == 0) || (*lvEnd != '\0') || (g_Cycles == ULLONG_MAX))
+			{
+				printf("Error Parsing cycle count %s, must be a positive number\n", lvValue);
+				error_led_set(true);
+				return -1;
+			}
+		}
+		else if(strcmp(argv[lvArg], "--no-sleep") == 0)
+		{
+			g_NoSleep = true;
+		}
+		else if(strcmp(argv[lvArg], "--quiet") == 0)
+		{
+			g_Quiet = true;
+		}
+		else if(strcmp(argv[lvArg], "--warm-start") == 0)
+		{
+			g_WarmStart = true;
+		}
+		else if((strcmp(argv[lvArg], "--motors") == 0) && (lvArg + 1 < argc))
+		{
+			char *lvEnd = NULL;
+			const char *lvValue = argv[++lvArg];
+			unsigned long lvMotors = (lvValue[0] >= '0' && lvValue[0] <= '9') ? strtoul(lvValue, &lvEnd, 10) : 0;
+
+			if((lvMotors == 0) || (*lvEnd != '\0') || (lvMotors > SPLIT_MAX_MOTORS) ||
+			   (torque_split_configure((unsigned int)lvMotors, NULL, NULL, NULL) != OK))
+			{
+				printf("Error Parsing motor count %s, must be between 1 and %d\n", lvValue, SPLIT_MAX_MOTORS);
+				error_led_set(true);
+				return -1;
+			}
+			printf("Splitting torque equally over %u motors\n", torque_split_motor_count());
+		}
+		else
+		{
+			printf("Error Parsing option %s\n", argv[lvArg]);
+			error_led_set(true);
+			return -1;
+		}
+	}
+  }
+  else if((argc == 2) && (strcmp(argv[1], "verify") == 0))
+  {
+	  printf("Comparing torque and ADC implementations against the reference model\n");
+	  printf("Filling torque structure for distinct two speed system\n");
+	  init_two_speed_torque_data();
+	  return run_accuracy_harness() == OK ? 0 : -1;
+  }
+  else if((argc == 2) && (strcmp(argv[1], "faults") == 0))
+  {
+	  (void)fault_recorder_init(FAULT_RECORDER_FILE);
+	  fault_recorder_dump();
+	  fault_recorder_close();
+	  return 0;
+  }
+  else if((argc == 2) && (strcmp(argv[1], "seqbench") == 0))
+  {
+	  printf("Measuring snapshot writer latency with concurrent readers\n");
+	  return torque_snapshot_benchmark(SNAPSHOT_BENCH_MAX_READERS) == OK ? 0 : -1;
   }
   else if((argc > 1) && (argc < 3))
   {
 	  printf("Select the following options: [default:1 - ts, 2 - pl]\n"
 			  "1 - ts or cs (ts = Two speed only selects 0 or 50 km/h values for speed)\n"
 			  "	   	(cs = randomly selects between 0 and 50 km/h values for speed)\n"
-			  "2 - mt or pl (mt = multi-threaded ; pl = plain implementation)\n");
+			  "2 - mt or pl (mt = multi-threaded ; pl = plain implementation)\n"
+			  "3 - optional: --rt (locks memory, pre-faults stacks and checks that\n"
+			  "	   	steady-state cycles do not page fault; heap allocations are\n"
+			  "	   	only checked when built with -DRT_ALLOCATION_HOOKS=1)\n"
+			  "    optional: --motors N (splits the torque equally over N motors)\n"
+			  "    optional: --cycles N (stops after N cycles and reports throughput)\n"
+			  "    optional: --no-sleep (runs the pipeline flat out)\n"
+			  "    optional: --quiet (no per cycle output)\n"
+			  "    optional: --warm-start (restores and periodically saves filter and table state)\n"
+			  "or  verify   (compares the implementations against the reference model)\n"
+			  "or  faults   (prints the recorded fault log)\n"
+			  "or  seqbench (measures snapshot writer latency with 1 to N readers)\n");
 	  return -1;
   }
   else
   {
 	  printf("Getting torque for two distinct speed values (0 and 50)km/h\n"
 			  "Using plain sequential implementation...\n");
-	  init_two_speed_torque_data();
+  }
+
+  /** Only the run modes record faults, the other modes leave the log untouched
+   * */
+  (void)fault_recorder_init(FAULT_RECORDER_FILE);
+
+  /** The tables are filled in both modes, so the output never depends on whether
+   *  a checkpoint exists. A valid checkpoint then skips the filter ramp.
+   */
+  printf("Filling torque structure for distinct two speed system\n");
+  init_two_speed_torque_data();
+  if(g_WarmStart) {
+	  (void)warm_start_load(WARM_START_FILE, WARM_START_MAX_AGE_S);
+  }
+
+  torque_cache_reset();
+  torque_stats_reset();
+  (void)signal(SIGUSR1, Request_Stats_Dump);
+  (void)signal(SIGINT, Request_Shutdown);
+  (void)signal(SIGTERM, Request_Shutdown);
+
+  if(g_RealtimeMemory) {
+	  (void)rt_memory_init();
+  }
+
+  if(g_Cycles) {
+	  profiler_start();
   }
 
   if(!g_ThreadedImplementation) {
@@ -359,7 +739,39 @@ int main(int argc, char *argv[])
 	  Thread_creator();
   }
 
-  /** should not reach here anyway
+  /** Only reached once --cycles N cycles are done or on SIGINT/SIGTERM
    * */
+  if(g_Cycles) {
+	  TorqueCacheStats_t lvCacheStats;
+	  torque_cache_get_stats(&lvCacheStats);
+
+	  printf("Execution mode: %s, %s\n", g_TwoSpeed ? "ts" : "cs", g_ThreadedImplementation ? "mt" : "pl");
+	  /** Failed passes only exist in plain mode, the threads retry a failed stage */
+	  profiler_report(stdout, !g_ThreadedImplementation);
+	  printf("Torque cache hits:%u misses:%u bypasses:%u\n",
+			  lvCacheStats.hits, lvCacheStats.misses, lvCacheStats.bypasses);
+  }
+  if(g_ThreadedImplementation) {
+	  watchdog_report(stdout);
+  }
+  if(g_RealtimeMemory) {
+	  RtMemoryStats_t lvRtStats;
+	  rt_memory_get_stats(&lvRtStats);
+	  printf("Real-time cycles checked:%llu", (unsigned long long)lvRtStats.cycles);
+	  #if RT_ALLOCATION_HOOKS
+		  printf(" allocating:%llu", (unsigned long long)lvRtStats.allocating_cycles);
+	  #else
+		  printf(" allocating:n/a");
+	  #endif
+	  printf(" faulting:%llu\n", (unsigned long long)lvRtStats.faulting_cycles);
+  }
+  /** All calculator threads have exited, so the state is captured by this thread */
+  if(g_WarmStart) {
+	  warm_start_capture();
+  }
+  if(g_WarmStart && (warm_start_save(WARM_START_FILE) == OK)) {
+	  printf("[WARM] Saved checkpoint %s\n", WARM_START_FILE);
+  }
+  fault_recorder_close();
   return 0;
 }